@@ -0,0 +1,274 @@
+#define INTERACTIVE_APPLY_UPDATES
+
+#include "interactive_update_1.cpp"
+#include "interactive_update_2.cpp"
+#include "interactive_update_3.cpp"
+#include "interactive_update_4.cpp"
+#include "interactive_update_5.cpp"
+#include "interactive_update_6.cpp"
+#include "interactive_update_7.cpp"
+#include "interactive_update_8.cpp"
+
+#include <glob.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Applies the updates of the updateStream_*.csv partitions in timestamp order with the code of the
+// interactive_update_* procedures, without the driver. Updates run in parallel within windows that end before the
+// first update depending (by the dependency timestamp of the streams) on an update of the window; an update that
+// still finds a vertex missing is retried after the rest of its window. After each window the database is flushed
+// and the timestamp of its last update is recorded in db_path/apply_updates.watermark, where the next run resumes.
+//   ./apply_updates db_path stream_dir [until_timestamp] [num_threads]
+
+#ifndef APPLY_UPDATES_MAX_WINDOW
+#define APPLY_UPDATES_MAX_WINDOW 100000
+#endif
+
+struct Update {
+    int64_t timestamp;
+    int64_t dependency_timestamp;
+    int16_t type;
+    std::string request;  // as sent to interactive_update_<type>
+};
+
+std::vector<std::string> Split(const std::string& s, char delimiter) {
+    std::vector<std::string> parts;
+    size_t begin = 0;
+    for (size_t end; (end = s.find(delimiter, begin)) != std::string::npos; begin = end + 1) {
+        parts.emplace_back(s, begin, end - begin);
+    }
+    parts.emplace_back(s, begin);
+    return parts;
+}
+
+// an empty list field holds no items
+std::vector<std::string> SplitList(const std::string& s, char delimiter) {
+    return s.empty() ? std::vector<std::string>() : Split(s, delimiter);
+}
+
+void WriteIds(std::stringstream& oss, const std::string& ids) {
+    auto items = SplitList(ids, ';');
+    WriteInt16(oss, items.size());
+    for (auto& id : items) WriteInt64(oss, std::stoll(id));
+}
+
+// organisationId,year;...
+void WriteOrganisationYears(std::stringstream& oss, const std::string& organisation_years) {
+    auto items = SplitList(organisation_years, ';');
+    WriteInt16(oss, items.size());
+    for (auto& item : items) {
+        auto id_year = Split(item, ',');
+        if (id_year.size() != 2) throw std::runtime_error("malformed organisation: " + item);
+        WriteInt64(oss, std::stoll(id_year[0]));
+        WriteInt32(oss, std::stoi(id_year[1]));
+    }
+}
+
+// Parameters of each update after timestamp|dependencyTimestamp|type, in the order of the LDBC driver: l INT64,
+// i INT32, s string, t tag ids, o organisation ids with years. Requests take them in the same order, except for
+// update 5, whose request starts with the person.
+Update ParseUpdate(const std::string& line) {
+    static const char* formats[] = {"", "lsssllsslsstoo", "lll", "lll", "lsllt", "lll", "lslssssilllt", "llsssillllt",
+                                    "lll"};
+    auto f = Split(line, '|');
+    if (f.size() < 3) throw std::runtime_error("malformed update: " + line);
+    Update update;
+    update.timestamp = std::stoll(f[0]);
+    update.dependency_timestamp = std::stoll(f[1]);
+    update.type = std::stoi(f[2]);
+    if (update.type < 1 || update.type > 8 || f.size() != 3 + strlen(formats[update.type])) {
+        throw std::runtime_error("malformed update: " + line);
+    }
+    // forumId|personId|joinDate
+    if (update.type == 5) std::swap(f[3], f[4]);
+    std::stringstream oss;
+    for (size_t i = 3; i < f.size(); i++) {
+        switch (formats[update.type][i - 3]) {
+            case 'l':
+                WriteInt64(oss, std::stoll(f[i]));
+                break;
+            case 'i':
+                WriteInt32(oss, std::stoi(f[i]));
+                break;
+            case 's':
+                WriteString(oss, f[i]);
+                break;
+            case 't':
+                WriteIds(oss, f[i]);
+                break;
+            case 'o':
+                WriteOrganisationYears(oss, f[i]);
+                break;
+        }
+    }
+    update.request = oss.str();
+    return update;
+}
+
+// merges the partitions, each of which is in timestamp order
+class UpdateStreams {
+   public:
+    explicit UpdateStreams(const std::vector<std::string>& paths) : heads_(paths.size()) {
+        for (size_t i = 0; i < paths.size(); i++) {
+            streams_.emplace_back(new std::ifstream(paths[i]));
+            if (!*streams_[i]) throw std::runtime_error("failed to open " + paths[i]);
+            if (Read(i)) queue_.emplace(heads_[i].timestamp, i);
+        }
+    }
+
+    bool Next(Update& update) {
+        if (queue_.empty()) return false;
+        size_t i = queue_.top().second;
+        queue_.pop();
+        update = std::move(heads_[i]);
+        if (Read(i)) queue_.emplace(heads_[i].timestamp, i);
+        return true;
+    }
+
+   private:
+    bool Read(size_t i) {
+        std::string line;
+        while (std::getline(*streams_[i], line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty()) continue;
+            heads_[i] = ParseUpdate(line);
+            return true;
+        }
+        return false;
+    }
+
+    std::vector<std::unique_ptr<std::ifstream>> streams_;
+    std::vector<Update> heads_;
+    std::priority_queue<std::pair<int64_t, size_t>, std::vector<std::pair<int64_t, size_t>>,
+                        std::greater<std::pair<int64_t, size_t>>>
+        queue_;
+};
+
+bool Apply(lgraph_api::GraphDB& db, const Update& update) {
+    using Procedure = bool (*)(lgraph_api::GraphDB&, std::stringstream&);
+    static const Procedure procedures[] = {InteractiveUpdate1, InteractiveUpdate2, InteractiveUpdate3,
+                                           InteractiveUpdate4, InteractiveUpdate5, InteractiveUpdate6,
+                                           InteractiveUpdate7, InteractiveUpdate8};
+    std::stringstream iss(update.request);
+    try {
+        return procedures[update.type - 1](db, iss);
+    } catch (std::exception& e) {
+        PluginLog("apply_updates") << "exception: " << e.what();
+        return false;
+    }
+}
+
+bool ApplyWindow(lgraph_api::GraphDB& db, const std::vector<Update>& window, int num_threads) {
+    std::vector<char> applied(window.size(), 0);
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&]() {
+            for (size_t i; (i = next++) < window.size();) applied[i] = Apply(db, window[i]);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    // dependencies the timestamps do not cover, e.g. replies to messages of the same window
+    for (size_t i = 0; i < window.size(); i++) {
+        if (applied[i] || Apply(db, window[i])) continue;
+        PluginLog("apply_updates") << "update " << window[i].type << " at " << window[i].timestamp << " failed";
+        return false;
+    }
+    return true;
+}
+
+int64_t ReadWatermark(const std::string& path) {
+    std::ifstream ifs(path);
+    int64_t watermark;
+    if (ifs >> watermark) return watermark;
+    return std::numeric_limits<int64_t>::min();
+}
+
+void WriteWatermark(const std::string& path, int64_t watermark) {
+    std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream ofs(tmp_path, std::ofstream::out | std::ofstream::trunc);
+        ofs << watermark << std::endl;
+        if (!ofs) throw std::runtime_error("failed to write " + tmp_path);
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) throw std::runtime_error("failed to write " + path);
+}
+
+std::vector<std::string> ListStreams(const std::string& stream_dir) {
+    std::vector<std::string> paths;
+    glob_t matches;
+    if (glob((stream_dir + "/updateStream_*.csv").c_str(), 0, nullptr, &matches) == 0) {
+        for (size_t i = 0; i < matches.gl_pathc; i++) paths.emplace_back(matches.gl_pathv[i]);
+    }
+    globfree(&matches);
+    return paths;
+}
+
+#ifndef UPDATE_WRITE_VOLUME
+int main(int argc, char** argv) {
+    std::string db_path(argv[1]);
+    std::string stream_dir(argv[2]);
+    int64_t until = argc > 3 ? std::stoll(argv[3]) : std::numeric_limits<int64_t>::max();
+    int num_threads = argc > 4 ? std::stoi(argv[4]) : std::thread::hardware_concurrency();
+
+    auto paths = ListStreams(stream_dir);
+    if (paths.empty()) {
+        std::cout << "no updateStream_*.csv in " << stream_dir << std::endl;
+        return 1;
+    }
+    std::string watermark_path = db_path + "/apply_updates.watermark";
+    int64_t watermark = ReadWatermark(watermark_path);
+
+    // commits are not synced one by one; each window is flushed before its watermark is recorded
+    lgraph_api::Galaxy galaxy(db_path, "admin", "73@TuGraph", false, false);
+    lgraph_api::GraphDB db = galaxy.OpenGraph("default");
+
+    UpdateStreams streams(paths);
+    Update update;
+    bool has_next = streams.Next(update);
+    while (has_next && update.timestamp <= watermark) has_next = streams.Next(update);
+
+    auto begin = std::chrono::steady_clock::now();
+    size_t num_applied = 0;
+    std::vector<Update> window;
+    while (has_next && update.timestamp <= until) {
+        window.clear();
+        int64_t window_begin = update.timestamp;
+        // a watermark covers whole timestamps, so updates with the same timestamp share a window
+        do {
+            window.emplace_back(std::move(update));
+            has_next = streams.Next(update);
+        } while (has_next && update.timestamp <= until &&
+                 (update.timestamp == window.back().timestamp ||
+                  (update.dependency_timestamp < window_begin && window.size() < APPLY_UPDATES_MAX_WINDOW)));
+        bool ok = ApplyWindow(db, window, num_threads);
+        db.Flush();
+        if (!ok) {
+            std::cout << "Stopped after the watermark " << watermark
+                      << "; updates after it may have been applied, so resume from a backup" << std::endl;
+            return 1;
+        }
+        watermark = window.back().timestamp;
+        WriteWatermark(watermark_path, watermark);
+        num_applied += window.size();
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << "Applied " << num_applied << " updates up to " << watermark << " (" << num_applied / elapsed
+                  << " updates/s)" << std::endl;
+    }
+    std::cout << "Watermark: " << watermark << std::endl;
+    return 0;
+}
+#endif
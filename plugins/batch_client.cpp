@@ -0,0 +1,98 @@
+#include "interactive_batch.cpp"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Builds batches of mixed short reads for persons and posts found in the database, runs them through the
+// interactive_batch procedure and through one emulated call per query (decode, read transaction, encode), and prints
+// the throughput of both. A last batch adds a query for a missing person, which fails on its own.
+//   ./batch_client db_path [batch_size] [rounds]
+
+std::vector<int64_t> FirstIds(lgraph_api::Transaction& txn, uint16_t label, size_t id_fid, size_t n) {
+    std::vector<int64_t> ids;
+    auto it = txn.GetVertexIndexIterator(label, id_fid, lgraph_api::FieldData::Int64(0),
+                                         lgraph_api::FieldData::Int64(std::numeric_limits<int64_t>::max()));
+    for (; it.IsValid() && ids.size() < n; it.Next()) ids.emplace_back(it.GetIndexValue().AsInt64());
+    return ids;
+}
+
+std::string EncodeBatch(const std::vector<std::pair<int16_t, std::string>>& queries) {
+    std::stringstream oss;
+    WriteInt16(oss, queries.size());
+    for (auto& query : queries) {
+        WriteInt16(oss, query.first);
+        WriteFrame(oss, query.second);
+    }
+    return lgraph_api::base64::Encode(oss.str());
+}
+
+int main(int argc, char** argv) {
+    std::string db_path(argv[1]);
+    int batch_size = argc > 2 ? std::stoi(argv[2]) : 64;
+    int rounds = argc > 3 ? std::stoi(argv[3]) : 1000;
+
+    lgraph_api::Galaxy galaxy(db_path, "admin", "73@TuGraph", true, false);
+    lgraph_api::GraphDB db = galaxy.OpenGraph("default");
+
+    std::vector<std::pair<int16_t, std::string>> queries;
+    {
+        auto txn = db.CreateReadTxn();
+        auto person_ids = FirstIds(txn, PERSON, PERSON_ID, batch_size);
+        auto post_ids = FirstIds(txn, POST, POST_ID, batch_size);
+        if (person_ids.empty() || post_ids.empty()) {
+            std::cout << "no persons or posts in " << db_path << std::endl;
+            return 1;
+        }
+        for (int i = 0; i < batch_size; i++) {
+            int16_t query = i % 7 + 1;
+            std::stringstream oss;
+            WriteInt64(oss, query <= 3 ? person_ids[i % person_ids.size()] : post_ids[i % post_ids.size()]);
+            queries.emplace_back(query, oss.str());
+        }
+    }
+
+    std::string request = EncodeBatch(queries);
+    std::string response;
+    auto begin = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        if (!Process(db, request, response)) {
+            std::cout << "batch failed: " << response << std::endl;
+            return 1;
+        }
+    }
+    double batch_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    begin = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (auto& query : queries) {
+            std::string input = lgraph_api::base64::Decode(lgraph_api::base64::Encode(query.second));
+            std::stringstream query_iss(input);
+            std::stringstream query_oss;
+            auto txn = db.CreateReadTxn();
+            short_reads[query.first - 1](db, txn, query_iss, query_oss);
+            response = query_oss.str();
+        }
+    }
+    double single_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    double num_queries = double(rounds) * queries.size();
+    std::cout << "batched\t" << num_queries / batch_seconds << " queries/s" << std::endl;
+    std::cout << "single\t" << num_queries / single_seconds << " queries/s" << std::endl;
+
+    std::stringstream missing_person;
+    WriteInt64(missing_person, -1);
+    queries.emplace_back(1, missing_person.str());
+    Process(db, EncodeBatch(queries), response);
+    std::stringstream iss(response);
+    int16_t num_results = ReadInt16(iss);
+    for (int16_t i = 0; i < num_results; i++) {
+        int16_t status = ReadInt16(iss);
+        std::string result = ReadFrame(iss);
+        std::cout << "IS" << queries[i].first << "\t" << (status == 0 ? "ok" : "failed") << "\t" << result.size()
+                  << " bytes" << std::endl;
+    }
+    return 0;
+}
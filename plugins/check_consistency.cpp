@@ -10,6 +10,25 @@
 
 using namespace lgraph_api;
 
+void CheckMessageCounts(VertexIterator& message, size_t like_count_fid, size_t reply_count_fid, std::mutex& mutex) {
+    int32_t like_count = 0;
+    int32_t reply_count = 0;
+    for (auto likes = lgraph_api::LabeledInEdgeIterator(message, LIKES); likes.IsValid(); likes.Next()) like_count ++;
+    for (auto replies = lgraph_api::LabeledInEdgeIterator(message, REPLYOF); replies.IsValid(); replies.Next()) reply_count ++;
+    auto fd = message[like_count_fid];
+    if (fd.is_null() || fd.integer() != like_count) {
+        mutex.lock();
+        printf("%lu .likeCount expects %d but gets %s\n", message.GetId(), like_count, fd.ToString().c_str());
+        mutex.unlock();
+    }
+    fd = message[reply_count_fid];
+    if (fd.is_null() || fd.integer() != reply_count) {
+        mutex.lock();
+        printf("%lu .replyCount expects %d but gets %s\n", message.GetId(), reply_count, fd.ToString().c_str());
+        mutex.unlock();
+    }
+}
+
 void CheckConsistency(GraphDB& db) {
     double exec_time = - omp_get_wtime();
 
@@ -41,6 +60,7 @@ void CheckConsistency(GraphDB& db) {
                             auto& person = vit;
                             std::unordered_map< int64_t, int32_t > post_count;
                             std::unordered_map< int64_t, double > weight_info;
+                            std::unordered_map< int64_t, double > interaction_info;
                             for (auto person_posts = lgraph_api::LabeledInEdgeIterator(person, POSTHASCREATOR); person_posts.IsValid(); person_posts.Next()) {
                                 auto post = txn.GetVertexIterator(person_posts.GetSrc());
                                 for (auto replies = lgraph_api::LabeledInEdgeIterator(post, REPLYOF); replies.IsValid(); replies.Next()) {
@@ -85,6 +105,7 @@ void CheckConsistency(GraphDB& db) {
                                     } else {
                                         weight_info.emplace(person_vid, 1.0);
                                     }
+                                    interaction_info[person_vid] += 1.0;
                                 } else {
                                     int64_t comment_vid = comment[COMMENT_REPLYOFCOMMENT].integer();
                                     comment.Goto(comment_vid);
@@ -95,6 +116,7 @@ void CheckConsistency(GraphDB& db) {
                                     } else {
                                         weight_info.emplace(person_vid, 0.5);
                                     }
+                                    interaction_info[person_vid] += 0.5;
                                 }
                             }
                             for (auto person_forums = lgraph_api::LabeledInEdgeIterator(person, HASMEMBER); person_forums.IsValid(); person_forums.Next()) {
@@ -108,6 +130,53 @@ void CheckConsistency(GraphDB& db) {
                                     mutex.unlock();
                                 }
                             }
+                            std::vector<RecentLike> recent_likers;
+                            std::vector<RecentReply> recent_replies;
+                            auto offer_likes_and_replies = [&](int64_t message_vid, int64_t message_id) {
+                                for (auto message_likes = lgraph_api::LabeledInEdgeIterator(txn, message_vid, LIKES); message_likes.IsValid(); message_likes.Next()) {
+                                    auto liker = txn.GetVertexIterator(message_likes.GetSrc());
+                                    OfferRecentLike(recent_likers, RecentLike{message_likes[LIKES_CREATIONDATE].integer(), liker[PERSON_ID].integer(), liker.GetId(), message_id, message_vid});
+                                }
+                                for (auto message_replies = lgraph_api::LabeledInEdgeIterator(txn, message_vid, REPLYOF); message_replies.IsValid(); message_replies.Next()) {
+                                    auto reply = txn.GetVertexIterator(message_replies.GetSrc());
+                                    OfferRecentReply(recent_replies, RecentReply{message_replies[REPLYOF_CREATIONDATE].integer(), reply[COMMENT_ID].integer(), reply.GetId(), reply[COMMENT_CREATOR].integer()});
+                                }
+                            };
+                            for (auto person_posts = lgraph_api::LabeledInEdgeIterator(person, POSTHASCREATOR); person_posts.IsValid(); person_posts.Next()) {
+                                auto post = txn.GetVertexIterator(person_posts.GetSrc());
+                                offer_likes_and_replies(post.GetId(), post[POST_ID].integer());
+                            }
+                            for (auto person_comments = lgraph_api::LabeledInEdgeIterator(person, COMMENTHASCREATOR); person_comments.IsValid(); person_comments.Next()) {
+                                auto comment = txn.GetVertexIterator(person_comments.GetSrc());
+                                offer_likes_and_replies(comment.GetId(), comment[COMMENT_ID].integer());
+                            }
+                            if (PackRecords(recent_likers).string() != PackRecords(UnpackRecords<RecentLike>(person[PERSON_RECENTLIKERS])).string()) {
+                                mutex.lock();
+                                printf("%lu .recentLikers mismatches\n", vid);
+                                mutex.unlock();
+                            }
+                            if (PackRecords(recent_replies).string() != PackRecords(UnpackRecords<RecentReply>(person[PERSON_RECENTREPLIES])).string()) {
+                                mutex.lock();
+                                printf("%lu .recentReplies mismatches\n", vid);
+                                mutex.unlock();
+                            }
+                            std::vector< std::tuple<int64_t, int64_t, int64_t> > work_records, work_in_country_records;
+                            for (auto person_work_at = lgraph_api::LabeledOutEdgeIterator(person, WORKAT); person_work_at.IsValid(); person_work_at.Next()) {
+                                auto work_from = person_work_at[WORKAT_WORKFROM];
+                                if (work_from.is_null()) continue;
+                                auto company = txn.GetVertexIterator(person_work_at.GetDst());
+                                work_records.emplace_back(company[ORGANISATION_PLACE].integer(), work_from.integer(), company.GetId());
+                            }
+                            for (auto person_countries = lgraph_api::LabeledOutEdgeIterator(person, WORKINCOUNTRY); person_countries.IsValid(); person_countries.Next()) {
+                                work_in_country_records.emplace_back(person_countries.GetDst(), person_countries[WORKINCOUNTRY_WORKFROM].integer(), person_countries[WORKINCOUNTRY_ORGANISATION].integer());
+                            }
+                            std::sort(work_records.begin(), work_records.end());
+                            std::sort(work_in_country_records.begin(), work_in_country_records.end());
+                            if (work_records != work_in_country_records) {
+                                mutex.lock();
+                                printf("%lu -[workInCountry]-> mismatches workAt\n", vid);
+                                mutex.unlock();
+                            }
                             for (auto person_friends = lgraph_api::LabeledOutEdgeIterator(person, KNOWS); person_friends.IsValid(); person_friends.Next()) {
                                 int64_t friend_vid = person_friends.GetDst();
                                 double weight = 0;
@@ -130,6 +199,51 @@ void CheckConsistency(GraphDB& db) {
                                     mutex.unlock();
                                 }
                             }
+                            interaction_info.erase(vid);
+                            for (auto person_interactions = lgraph_api::LabeledOutEdgeIterator(person, INTERACTION); person_interactions.IsValid(); person_interactions.Next()) {
+                                int64_t person_vid = person_interactions.GetDst();
+                                double weight = 0;
+                                auto it = interaction_info.find(person_vid);
+                                if (it != interaction_info.end()) {
+                                    weight = it->second;
+                                    interaction_info.erase(it);
+                                }
+                                if (weight != person_interactions[INTERACTION_WEIGHT].real()) {
+                                    mutex.lock();
+                                    printf("%lu -[interaction]-> %lu .weight expects %lf but gets %lf\n", vid, person_vid, weight, person_interactions[INTERACTION_WEIGHT].real());
+                                    mutex.unlock();
+                                }
+                            }
+                            for (auto& kv : interaction_info) {
+                                mutex.lock();
+                                printf("%lu -[interaction]-> %lu is missing (weight %lf)\n", vid, kv.first, kv.second);
+                                mutex.unlock();
+                            }
+                            break;
+                        }
+                        case POST: {
+                            CheckMessageCounts(vit, POST_LIKECOUNT, POST_REPLYCOUNT, mutex);
+                            break;
+                        }
+                        case COMMENT: {
+                            CheckMessageCounts(vit, COMMENT_LIKECOUNT, COMMENT_REPLYCOUNT, mutex);
+                            auto message = txn.GetVertexIterator(vid);
+                            while (message[COMMENT_REPLYOFPOST].is_null()) message.Goto(message[COMMENT_REPLYOFCOMMENT].integer());
+                            int64_t post_vid = message[COMMENT_REPLYOFPOST].integer();
+                            message.Goto(post_vid);
+                            int64_t forum_vid = message[POST_CONTAINER].integer();
+                            auto root_post = vit[COMMENT_ROOTPOST];
+                            auto root_forum = vit[COMMENT_ROOTFORUM];
+                            if (root_post.is_null() || root_post.integer() != post_vid) {
+                                mutex.lock();
+                                printf("%lu .rootPost expects %ld but gets %s\n", vid, post_vid, root_post.ToString().c_str());
+                                mutex.unlock();
+                            }
+                            if (root_forum.is_null() || root_forum.integer() != forum_vid) {
+                                mutex.lock();
+                                printf("%lu .rootForum expects %ld but gets %s\n", vid, forum_vid, root_forum.ToString().c_str());
+                                mutex.unlock();
+                            }
                             break;
                         }
                         default: {
@@ -1,6 +1,7 @@
 #include "lgraph/lgraph.h"
 
 #include <fstream>
+#include <set>
 
 std::string ToUpper(const std::string& input) {
     std::string output;
@@ -10,9 +11,54 @@ std::string ToUpper(const std::string& input) {
     return output;
 }
 
+std::string FieldTypeName(lgraph_api::FieldType type) {
+    switch (type) {
+        case lgraph_api::FieldType::BOOL:
+            return "BOOL";
+        case lgraph_api::FieldType::INT8:
+            return "INT8";
+        case lgraph_api::FieldType::INT16:
+            return "INT16";
+        case lgraph_api::FieldType::INT32:
+            return "INT32";
+        case lgraph_api::FieldType::INT64:
+            return "INT64";
+        case lgraph_api::FieldType::FLOAT:
+            return "FLOAT";
+        case lgraph_api::FieldType::DOUBLE:
+            return "DOUBLE";
+        case lgraph_api::FieldType::DATE:
+            return "DATE";
+        case lgraph_api::FieldType::DATETIME:
+            return "DATETIME";
+        case lgraph_api::FieldType::STRING:
+            return "STRING";
+        case lgraph_api::FieldType::BLOB:
+            return "BLOB";
+        default:
+            throw std::runtime_error("unsupported field type");
+    }
+}
+
+// fields holding vids once preprocess has run: converted foreign keys and filled-in references
+const std::set<std::string> vid_fields = {
+    "Comment.creator", "Comment.place", "Comment.replyOfPost", "Comment.replyOfComment", "Comment.rootPost",
+    "Comment.rootForum", "Forum.moderator", "Organisation.place", "Person.place", "Place.isPartOf", "Post.creator",
+    "Post.container", "Post.place", "Tag.hasType", "Tagclass.isSubclassOf", "workInCountry.organisation"};
+
+void WriteFieldTraits(std::ofstream& ofs, const char* kind, const std::string& label, const std::string& field,
+                      const lgraph_api::FieldSpec& spec) {
+    bool vid = vid_fields.count(label + "." + spec.name) != 0;
+    ofs << "template <>" << std::endl;
+    ofs << "struct " << kind << "<" << ToUpper(label) << ", " << field << ">" << std::endl;
+    ofs << "    : FieldTraits<lgraph_api::FieldType::" << FieldTypeName(spec.type) << ", "
+        << (spec.optional ? "true" : "false") << ", " << (vid ? "true" : "false") << "> {};" << std::endl;
+}
+
 int main(int argc, char** argv) {
     std::string db_path(argv[1]);
     std::string file_path(argv[2]);
+    std::string schema_path(argc > 3 ? argv[3] : "snb_schema.h");
 
     lgraph_api::Galaxy galaxy(db_path, "admin", "73@TuGraph", true, false);
     lgraph_api::GraphDB db = galaxy.OpenGraph("default");
@@ -20,6 +66,12 @@ int main(int argc, char** argv) {
     auto txn = db.CreateReadTxn();
 
     std::ofstream ofs(file_path, std::ofstream::out | std::ofstream::trunc);
+    std::ofstream sfs(schema_path, std::ofstream::out | std::ofstream::trunc);
+    sfs << "// Generated by generate_snb_constants: VertexField and EdgeField specializations of the schema."
+        << std::endl;
+    sfs << "#pragma once" << std::endl << std::endl;
+    sfs << "#include \"snb_constants.h\"" << std::endl;
+    sfs << "#include \"snb_fields.h\"" << std::endl;
 
     auto v_labels = txn.ListVertexLabels();
     for (auto& v_label : v_labels) {
@@ -30,6 +82,8 @@ int main(int argc, char** argv) {
             auto& v_field_name = v_field.name;
             auto v_field_id = txn.GetVertexFieldId(v_label_id, v_field_name);
             ofs << "#define " << ToUpper(v_label) << "_" << ToUpper(v_field_name) << " " << v_field_id << std::endl;
+            sfs << std::endl;
+            WriteFieldTraits(sfs, "VertexField", v_label, ToUpper(v_label) + "_" + ToUpper(v_field_name), v_field);
         }
         ofs << std::endl;
     }
@@ -43,6 +97,8 @@ int main(int argc, char** argv) {
             auto& e_field_name = e_field.name;
             auto e_field_id = txn.GetEdgeFieldId(e_label_id, e_field_name);
             ofs << "#define " << ToUpper(e_label) << "_" << ToUpper(e_field_name) << " " << e_field_id << std::endl;
+            sfs << std::endl;
+            WriteFieldTraits(sfs, "EdgeField", e_label, ToUpper(e_label) + "_" + ToUpper(e_field_name), e_field);
         }
         ofs << std::endl;
     }
@@ -0,0 +1,89 @@
+#include "lgraph/lgraph.h"
+
+#include "snb_constants.h"
+#include "snb_common.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Throughput and latency of small durable write transactions on the disk holding db_path, first syncing every commit
+// (what "durable": true does) and then with GroupCommit at increasing collection windows. Uses its own scratch
+// database, like acid.
+//   ./group_commit_bench [db_path] [num_threads] [seconds_per_run]
+
+void Initialize(lgraph_api::GraphDB& db) {
+    db.DropAllData();
+    bool ok = db.AddVertexLabel("Event", {
+        {"id", lgraph_api::FieldType::INT64, false},
+        {"payload", lgraph_api::FieldType::STRING, false}
+    }, "id");
+    if (!ok) throw std::runtime_error("failed to register label Event");
+}
+
+// window_us < 0 flushes after every commit
+void Run(lgraph_api::GraphDB& db, int num_threads, double seconds, int64_t window_us) {
+    auto& group_commit = GroupCommit::Get();
+    auto counters_before = group_commit.Counters();
+    std::atomic<int64_t> next_id{0};
+    std::vector< std::vector<int64_t> > latencies(num_threads);
+    const std::string payload(256, 'x');
+    auto begin = std::chrono::steady_clock::now();
+    auto deadline = begin + std::chrono::microseconds(int64_t(seconds * 1e6));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t ++) {
+        threads.emplace_back([&, t]() {
+            while (std::chrono::steady_clock::now() < deadline) {
+                auto start = std::chrono::steady_clock::now();
+                auto txn = db.CreateWriteTxn();
+                txn.AddVertex("Event", {"id", "payload"},
+                              {lgraph_api::FieldData::Int64(next_id ++), lgraph_api::FieldData::String(payload)});
+                txn.Commit();
+                if (window_us < 0) {
+                    db.Flush();
+                } else {
+                    group_commit.WaitDurable(db, group_commit.Committed(), window_us);
+                }
+                latencies[t].push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start).count());
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::vector<int64_t> all;
+    for (auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+    std::sort(all.begin(), all.end());
+    auto counters_after = group_commit.Counters();
+    uint64_t flushes = counters_after.second - counters_before.second;
+    double group_size = window_us < 0 ? 1.0 :
+        (flushes == 0 ? 0.0 : double(counters_after.first - counters_before.first) / flushes);
+    auto percentile = [&](double p) { return all.empty() ? 0 : all[size_t(p * (all.size() - 1))]; };
+    std::cout << (window_us < 0 ? "per-commit" : "group") << "\t" << std::max<int64_t>(window_us, 0) << "\t"
+              << num_threads << "\t" << all.size() / elapsed << "\t" << group_size << "\t" << percentile(0.5) << "\t"
+              << percentile(0.99) << "\t" << (all.empty() ? 0 : all.back()) << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::string db_path(argc > 1 ? argv[1] : "./benchdb");
+    int num_threads = argc > 2 ? std::stoi(argv[2]) : 64;
+    double seconds = argc > 3 ? std::stod(argv[3]) : 10;
+
+    // not durable: syncing is left to the benchmark
+    lgraph_api::Galaxy galaxy(db_path, "admin", "73@TuGraph", false, true);
+    auto db = galaxy.OpenGraph("default");
+    Initialize(db);
+
+    std::cout << "mode\twindow_us\tthreads\ttxns/s\tavg_group_size\tp50_us\tp99_us\tmax_us" << std::endl;
+    Run(db, num_threads, seconds, -1);
+    for (int64_t window_us : {0, 50, 100, 200, 500, 1000}) {
+        Run(db, num_threads, seconds, window_us);
+    }
+
+    return 0;
+}
@@ -0,0 +1,68 @@
+// Short reads are tiny, so per-call costs (RPC, base64, creating a transaction) dominate them. This procedure runs a
+// batch of them, of the same or mixed types, against one read snapshot and answers them in one response.
+//
+// request (base64-encoded):
+//   INT16 n, then n times { INT16 query (1-7 for Short Read 1-7), INT32 size, the query's own request, not encoded }
+// response:
+//   INT16 n, then n times { INT16 status (0 ok, 1 failed), INT32 size, the query's own response (empty if failed) }
+// A failing query does not fail the batch; only a malformed batch does.
+
+#define INTERACTIVE_BATCH
+
+#include "interactive_short_read_1.cpp"
+#include "interactive_short_read_2.cpp"
+#include "interactive_short_read_3.cpp"
+#include "interactive_short_read_4.cpp"
+#include "interactive_short_read_5.cpp"
+#include "interactive_short_read_6.cpp"
+#include "interactive_short_read_7.cpp"
+
+using ShortRead = void (*)(lgraph_api::GraphDB&, lgraph_api::Transaction&, std::stringstream&, std::stringstream&);
+
+static const ShortRead short_reads[] = {InteractiveShortRead1, InteractiveShortRead2, InteractiveShortRead3,
+                                        InteractiveShortRead4, InteractiveShortRead5, InteractiveShortRead6,
+                                        InteractiveShortRead7};
+
+extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std::string& response) {
+    std::string input = lgraph_api::base64::Decode(request);
+    std::stringstream iss(input);
+    int16_t num_queries = ReadInt16(iss);
+    if (!iss || num_queries < 0) {
+        response = "malformed batch";
+        return false;
+    }
+    // split the batch up front, so that a malformed batch fails before any query runs
+    std::vector<std::pair<int16_t, std::string>> queries;
+    try {
+        for (int16_t i = 0; i < num_queries; i++) {
+            int16_t query = ReadInt16(iss);
+            queries.emplace_back(query, ReadFrame(iss));
+        }
+    } catch (std::exception& e) {
+        response = "malformed batch";
+        return false;
+    }
+
+    auto txn = db.CreateReadTxn();
+    std::stringstream oss;
+    WriteInt16(oss, num_queries);
+    for (auto& query : queries) {
+        std::stringstream query_iss(query.second);
+        std::stringstream query_oss;
+        int16_t status = 0;
+        try {
+            if (query.first < 1 || query.first > 7) {
+                throw std::runtime_error("unknown short read " + std::to_string(query.first));
+            }
+            short_reads[query.first - 1](db, txn, query_iss, query_oss);
+        } catch (std::exception& e) {
+            PluginLog("interactive_batch") << "exception: " << e.what();
+            status = 1;
+            query_oss.str("");
+        }
+        WriteInt16(oss, status);
+        WriteFrame(oss, query_oss.str());
+    }
+    response = oss.str();
+    return true;
+}
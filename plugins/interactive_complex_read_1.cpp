@@ -1,95 +1,148 @@
-#include <set>
 #include <tuple>
 
 #include "lgraph/lgraph.h"
 #include "snb_common.h"
 #include "snb_constants.h"
-#include "tsl/hopscotch_set.h"
+
+// Distance between src and dst if it is at most max_distance, -1 otherwise. The side with the smaller frontier is
+// expanded one level at a time until the two searches meet.
+int BoundedDistance(lgraph_api::Transaction& txn, int64_t src, int64_t dst, int max_distance) {
+    if (src == dst) return 0;
+    ArenaHashMap<int64_t, int> depths[2] = {{{src, 0}}, {{dst, 0}}};
+    ArenaVector<int64_t> frontiers[2] = {{src}, {dst}};
+    int levels[2] = {0, 0};
+    auto person = txn.GetVertexIterator();
+    while (levels[0] + levels[1] < max_distance) {
+        int side = frontiers[0].size() <= frontiers[1].size() ? 0 : 1;
+        auto& visited = depths[side];
+        auto& others = depths[1 - side];
+        int level = ++levels[side];
+        int distance = -1;
+        ArenaVector<int64_t> next_frontier;
+        auto visit = [&](int64_t vid) {
+            if (visited.find(vid) != visited.end()) return;
+            visited.emplace(vid, level);
+            next_frontier.emplace_back(vid);
+            auto it = others.find(vid);
+            if (it != others.end() && (distance == -1 || level + it->second < distance)) {
+                distance = level + it->second;
+            }
+        };
+        for (auto vid : frontiers[side]) {
+            person.Goto(vid);
+            for (auto person_friends = lgraph_api::LabeledOutEdgeIterator(person, KNOWS); person_friends.IsValid();
+                 person_friends.Next()) {
+                visit(person_friends.GetDst());
+            }
+            for (auto person_friends = lgraph_api::LabeledInEdgeIterator(person, KNOWS); person_friends.IsValid();
+                 person_friends.Next()) {
+                visit(person_friends.GetSrc());
+            }
+        }
+        if (distance != -1) return distance;
+        if (next_frontier.empty()) return -1;
+        frontiers[side].swap(next_frontier);
+    }
+    return -1;
+}
 
 extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std::string& response) {
     constexpr size_t limit_results = 20;
+    // names shared by at most this many persons are resolved through the firstName index
+    constexpr size_t rare_name_limit = 64;
+    ArenaScope arena("interactive_complex_read_1");
     std::string input = lgraph_api::base64::Decode(request);
     std::stringstream iss(input);
     int64_t person_id = ReadInt64(iss);
     std::string first_name = ReadString(iss);
 
     auto txn = db.CreateReadTxn();
-    std::set<std::tuple<int, std::string, int64_t, int64_t> > candidates;
+    TopK<std::tuple<int, std::string, int64_t, int64_t>, limit_results> candidates;
     auto fd = lgraph_api::FieldData::Int64(person_id);
     auto iit = txn.GetVertexIndexIterator(PERSON, PERSON_ID, fd, fd);
     int64_t start_vid = iit.GetVid();
-    std::vector<int64_t> curr_frontier({start_vid});
-    tsl::hopscotch_set<int64_t> visited({start_vid});
     auto person = txn.GetVertexIterator();
-
-    for (int distance = 0; distance <= 3; distance++) {
-        std::vector<int64_t> next_frontier;
-        for (auto vid : curr_frontier) {
+    auto offer = [&](int distance, int64_t vid) {
+        candidates.Offer(distance, [&]() {
             person.Goto(vid);
-            if (person.GetId() == start_vid || person[PERSON_FIRSTNAME].string() != first_name) continue;
-            std::string last_name = person[PERSON_LASTNAME].string();
-            int64_t person_id = person[PERSON_ID].integer();
-            auto tup = std::make_tuple(distance, last_name, person_id, vid);
-            if (candidates.size() >= limit_results) {
-                auto& candidate = *candidates.rbegin();
-                if (tup > candidate) continue;
-            }
-            candidates.emplace(tup);
-            if (candidates.size() > limit_results) {
-                candidates.erase(--candidates.end());
-            }
+            return std::make_tuple(distance, Vertex<PERSON>::Get<PERSON_LASTNAME>(person),
+                                   Vertex<PERSON>::Get<PERSON_ID>(person), vid);
+        });
+    };
+
+    // counting index entries up to the limit serves as the cardinality estimate of the name
+    ArenaVector<int64_t> namesakes;
+    {
+        auto name = lgraph_api::FieldData::String(first_name);
+        for (auto nit = txn.GetVertexIndexIterator(PERSON, PERSON_FIRSTNAME, name, name);
+             nit.IsValid() && namesakes.size() <= rare_name_limit; nit.Next()) {
+            namesakes.emplace_back(nit.GetVid());
         }
-        if (candidates.size() >= limit_results || distance == 3) break;
-        for (auto vid : curr_frontier) {
-            person.Goto(vid);
-            for (auto person_friends = lgraph_api::LabeledOutEdgeIterator(person, KNOWS); person_friends.IsValid();
-                 person_friends.Next()) {
-                int64_t friend_vid = person_friends.GetDst();
-                if (visited.find(friend_vid) == visited.end()) {
-                    visited.emplace(friend_vid);
-                    next_frontier.emplace_back(friend_vid);
-                }
+    }
+    if (namesakes.size() <= rare_name_limit) {
+        for (auto vid : namesakes) {
+            if (vid == start_vid) continue;
+            int distance = BoundedDistance(txn, start_vid, vid, 3);
+            if (distance > 0) offer(distance, vid);
+        }
+    } else {
+        ArenaVector<int64_t> curr_frontier({start_vid});
+        ArenaHashSet<int64_t> visited({start_vid});
+        for (int distance = 0; distance <= 3; distance++) {
+            ArenaVector<int64_t> next_frontier;
+            for (auto vid : curr_frontier) {
+                person.Goto(vid);
+                if (person.GetId() == start_vid || !StringEquals(person, PERSON_FIRSTNAME, first_name)) continue;
+                offer(distance, vid);
             }
-            for (auto person_friends = lgraph_api::LabeledInEdgeIterator(person, KNOWS); person_friends.IsValid();
-                 person_friends.Next()) {
-                int64_t friend_vid = person_friends.GetSrc();
-                if (visited.find(friend_vid) == visited.end()) {
-                    visited.emplace(friend_vid);
-                    next_frontier.emplace_back(friend_vid);
+            if (candidates.full() || distance == 3) break;
+            for (auto vid : curr_frontier) {
+                person.Goto(vid);
+                for (auto person_friends = lgraph_api::LabeledOutEdgeIterator(person, KNOWS); person_friends.IsValid();
+                     person_friends.Next()) {
+                    int64_t friend_vid = person_friends.GetDst();
+                    if (visited.find(friend_vid) == visited.end()) {
+                        visited.emplace(friend_vid);
+                        next_frontier.emplace_back(friend_vid);
+                    }
+                }
+                for (auto person_friends = lgraph_api::LabeledInEdgeIterator(person, KNOWS); person_friends.IsValid();
+                     person_friends.Next()) {
+                    int64_t friend_vid = person_friends.GetSrc();
+                    if (visited.find(friend_vid) == visited.end()) {
+                        visited.emplace(friend_vid);
+                        next_frontier.emplace_back(friend_vid);
+                    }
                 }
             }
+            std::sort(next_frontier.begin(), next_frontier.end());
+            curr_frontier.swap(next_frontier);
         }
-        std::sort(next_frontier.begin(), next_frontier.end());
-        curr_frontier.swap(next_frontier);
     }
     // output result
     std::stringstream oss;
     WriteInt16(oss, candidates.size());
-    auto place = txn.GetVertexIterator();
-    auto organisation = txn.GetVertexIterator();
-    for (auto it = candidates.begin(); it != candidates.end(); it++) {
-        auto& tup = *it;
+    auto& dimensions = Dimensions::Get(txn);
+    for (auto& tup : candidates.Sorted()) {
         int64_t vid = std::get<3>(tup);
         person.Goto(vid);
         WriteInt64(oss, std::get<2>(tup));
         WriteString(oss, std::get<1>(tup));
         WriteInt32(oss, std::get<0>(tup));
-        WriteInt64(oss, person[PERSON_BIRTHDAY].integer());
-        WriteInt64(oss, person[PERSON_CREATIONDATE].integer());
-        WriteString(oss, person[PERSON_GENDER].string());
-        WriteString(oss, person[PERSON_BROWSERUSED].string());
-        WriteString(oss, person[PERSON_LOCATIONIP].string());
-        WriteString(oss, person[PERSON_EMAIL].string());
-        WriteString(oss, person[PERSON_SPEAKS].string());
-        place.Goto(person[PERSON_PLACE].integer());
-        WriteString(oss, place[PLACE_NAME].string());
+        WriteInt64(oss, Vertex<PERSON>::Get<PERSON_BIRTHDAY>(person));
+        WriteInt64(oss, Vertex<PERSON>::Get<PERSON_CREATIONDATE>(person));
+        WriteStringField(oss, person, PERSON_GENDER);
+        WriteStringField(oss, person, PERSON_BROWSERUSED);
+        WriteStringField(oss, person, PERSON_LOCATIONIP);
+        WriteStringField(oss, person, PERSON_EMAIL);
+        WriteStringField(oss, person, PERSON_SPEAKS);
+        WriteString(oss, dimensions.Name(Vertex<PERSON>::Get<PERSON_PLACE>(person)));
         std::vector<std::tuple<std::string, int32_t, std::string> > list_exp;
         for (auto person_study_at = lgraph_api::LabeledOutEdgeIterator(person, STUDYAT); person_study_at.IsValid();
              person_study_at.Next()) {
-            organisation.Goto(person_study_at.GetDst());
-            place.Goto(organisation[ORGANISATION_PLACE].integer());
-            list_exp.emplace_back(organisation[ORGANISATION_NAME].string(),
-                                  person_study_at[STUDYAT_CLASSYEAR].integer(), place[PLACE_NAME].string());
+            auto& organisation = dimensions[person_study_at.GetDst()];
+            list_exp.emplace_back(organisation.name, Edge<STUDYAT>::Get<STUDYAT_CLASSYEAR>(person_study_at),
+                                  dimensions.Name(organisation.parent));
         }
         WriteInt16(oss, list_exp.size());
         for (auto& tup : list_exp) {
@@ -100,10 +153,9 @@ extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std
         list_exp.clear();
         for (auto person_work_at = lgraph_api::LabeledOutEdgeIterator(person, WORKAT); person_work_at.IsValid();
              person_work_at.Next()) {
-            organisation.Goto(person_work_at.GetDst());
-            place.Goto(organisation[ORGANISATION_PLACE].integer());
-            list_exp.emplace_back(organisation[ORGANISATION_NAME].string(), person_work_at[WORKAT_WORKFROM].integer(),
-                                  place[PLACE_NAME].string());
+            auto& organisation = dimensions[person_work_at.GetDst()];
+            list_exp.emplace_back(organisation.name, Edge<WORKAT>::GetRequired<WORKAT_WORKFROM>(person_work_at),
+                                  dimensions.Name(organisation.parent));
         }
         WriteInt16(oss, list_exp.size());
         for (auto& tup : list_exp) {
@@ -1,18 +1,59 @@
-#include <set>
+#include <limits>
 #include <tuple>
 
 #include "lgraph/lgraph.h"
 #include "lgraph/lgraph_traversal.h"
 #include "snb_common.h"
 #include "snb_constants.h"
-#include "tsl/hopscotch_set.h"
 
 using namespace lgraph_api;
 
 constexpr int worker_num = 4;
 
+// Birthday of every person in the longest run of consecutive person vids (the imported persons) as a month-day
+// ordinal, indexed by vid - base_. Vids of persons created by updates are interleaved with those of their messages,
+// so covering them densely could take a slot per message; they are read from the store instead.
+class BirthdayColumn {
+    int64_t base_ = 0;
+    std::vector<int16_t> ordinals_;
+
+   public:
+    explicit BirthdayColumn(Transaction &txn) {
+        std::vector<std::pair<int64_t, int64_t>> persons;
+        auto vit = txn.GetVertexIterator();
+        for (auto iit = txn.GetVertexIndexIterator(PERSON, PERSON_ID,
+                                                   FieldData::Int64(std::numeric_limits<int64_t>::min()),
+                                                   FieldData::Int64(std::numeric_limits<int64_t>::max()));
+             iit.IsValid(); iit.Next()) {
+            vit.Goto(iit.GetVid());
+            persons.emplace_back(vit.GetId(), Vertex<PERSON>::Get<PERSON_BIRTHDAY>(vit));
+        }
+        if (persons.empty()) return;
+        std::sort(persons.begin(), persons.end());
+        size_t begin = 0, end = 0;
+        for (size_t i = 0, j; i < persons.size(); i = j) {
+            for (j = i + 1; j < persons.size() && persons[j].first == persons[j - 1].first + 1; j++) {
+            }
+            if (j - i > end - begin) begin = i, end = j;
+        }
+        base_ = persons[begin].first;
+        std::vector<int64_t> birthdays(end - begin);
+        for (size_t i = begin; i < end; i++) birthdays[i - begin] = persons[i].second;
+        std::vector<int32_t> ordinals(birthdays.size());
+        GetMonthDayOrdinals(birthdays.data(), birthdays.size(), ordinals.data());
+        ordinals_.assign(ordinals.begin(), ordinals.end());
+    }
+
+    // 0 if the vid is not covered
+    int32_t Get(int64_t vid) const {
+        uint64_t i = vid - base_;
+        return i < ordinals_.size() ? ordinals_[i] : 0;
+    }
+};
+
 extern "C" bool Process(lgraph_api::GraphDB &db, const std::string &request, std::string &response) {
     constexpr size_t limit_results = 10;
+    ArenaScope arena("interactive_complex_read_10");
     std::string input = base64::Decode(request);
     std::stringstream iss(input);
     int64_t person_id = ReadInt64(iss);
@@ -21,12 +62,12 @@ extern "C" bool Process(lgraph_api::GraphDB &db, const std::string &request, std
 
     auto txn = db.CreateReadTxn();
     auto person = txn.GetVertexByUniqueIndex(PERSON, PERSON_ID, FieldData::Int64(person_id));
-    tsl::hopscotch_set<int64_t> interested_tags;
+    ArenaHashSet<int64_t> interested_tags;
     for (auto person_tags = LabeledOutEdgeIterator(person, HASINTEREST); person_tags.IsValid(); person_tags.Next()) {
         interested_tags.emplace(person_tags.GetDst());
     }
     int64_t start_vid = person.GetId();
-    tsl::hopscotch_set<int64_t> visited({start_vid});
+    ArenaHashSet<int64_t> visited({start_vid});
     std::vector<int64_t> curr_frontier({start_vid});
     auto person_out_friends = LabeledOutEdgeIterator(person, KNOWS);
     auto person_in_friends = LabeledInEdgeIterator(person, KNOWS);
@@ -54,21 +95,43 @@ extern "C" bool Process(lgraph_api::GraphDB &db, const std::string &request, std
     }
     auto &two_hop_friends = curr_frontier;
     std::sort(two_hop_friends.begin(), two_hop_friends.end());
-    using result_type = std::set<std::tuple<int32_t, int64_t, int64_t>>;
+    // keep the friends born between the 21st of this month and the 22nd of the next one before touching any vertex
+    static const BirthdayColumn birthdays(txn);
+    ArenaVector<int32_t> ordinals(two_hop_friends.size());
+    for (size_t i = 0; i < two_hop_friends.size(); i++) {
+        ordinals[i] = birthdays.Get(two_hop_friends[i]);
+        if (ordinals[i] == 0) {
+            person.Goto(two_hop_friends[i]);
+            ordinals[i] = GetMonthDayOrdinal(Vertex<PERSON>::Get<PERSON_BIRTHDAY>(person));
+        }
+    }
+    const int32_t this_month_begin = MonthDayOrdinal(month, 21);
+    const int32_t next_month_begin = MonthDayOrdinal(next_month, 1);
+    const uint32_t this_month_span = MonthDayOrdinal(month, 31) - this_month_begin;
+    const uint32_t next_month_span = MonthDayOrdinal(next_month, 21) - next_month_begin;
+    ArenaVector<uint8_t> matches(ordinals.size());
+#pragma omp simd
+    for (size_t i = 0; i < ordinals.size(); i++) {
+        matches[i] = (static_cast<uint32_t>(ordinals[i] - this_month_begin) <= this_month_span) |
+                     (static_cast<uint32_t>(ordinals[i] - next_month_begin) <= next_month_span);
+    }
+    size_t num_matches = 0;
+    for (size_t i = 0; i < two_hop_friends.size(); i++) {
+        two_hop_friends[num_matches] = two_hop_friends[i];
+        num_matches += matches[i];
+    }
+    two_hop_friends.resize(num_matches);
+    using result_type = TopK<std::tuple<int32_t, int64_t, int64_t>, limit_results>;
     static std::vector<Worker> workers(worker_num);
     auto candidates = ForEachVertex<result_type>(
         db, txn, workers, two_hop_friends,
         [&](Transaction &t, VertexIterator &vit, result_type &local) {
             auto msg_it = t.GetVertexIterator();
-            auto month_day = GetMonthDay(vit[PERSON_BIRTHDAY].integer());
-            bool ok = (month_day.first == month && month_day.second >= 21) ||
-                      (month_day.first == next_month && month_day.second < 22);
-            if (!ok) return;
             int32_t score = 0;
             for (auto person_msgs = LabeledInEdgeIterator(vit, POSTHASCREATOR); person_msgs.IsValid();
                  person_msgs.Next()) {
                 msg_it.Goto(person_msgs.GetSrc());
-                ok = false;
+                bool ok = false;
                 for (auto post_ts = LabeledOutEdgeIterator(msg_it, POSTHASTAG); post_ts.IsValid(); post_ts.Next()) {
                     if (interested_tags.find(post_ts.GetDst()) != interested_tags.end()) {
                         ok = true;
@@ -77,39 +140,22 @@ extern "C" bool Process(lgraph_api::GraphDB &db, const std::string &request, std
                 }
                 score += (ok ? +1 : -1);
             }
-            int64_t person_id = -1;
-            if (local.size() >= limit_results) {
-                auto &cand = *local.rbegin();
-                if (0 - score > std::get<0>(cand)) return;
-                if (0 - score == std::get<0>(cand)) {
-                    person_id = vit[PERSON_ID].integer();
-                    if (person_id > std::get<1>(cand)) return;
-                }
-            }
-            if (person_id == -1) person_id = vit[PERSON_ID].integer();
-            local.emplace(0 - score, person_id, vit.GetId());
-            if (local.size() > limit_results) {
-                local.erase(--local.end());
-            }
+            local.Offer(0 - score,
+                        [&]() { return std::make_tuple(0 - score, Vertex<PERSON>::Get<PERSON_ID>(vit), vit.GetId()); });
         },
-        [&](const result_type &local, result_type &res) {
-            for (auto &r : local) res.emplace(r);
-        }, 10);
+        [&](const result_type &local, result_type &res) { res.Merge(local); }, 10);
     // output results
+    auto &dimensions = Dimensions::Get(txn);
     std::stringstream oss;
-    int res_size = std::min(candidates.size(), limit_results);
-    int res_count = 0;
-    WriteInt16(oss, res_size);
-    for (auto &tup : candidates) {
+    WriteInt16(oss, candidates.size());
+    for (auto &tup : candidates.Sorted()) {
         WriteInt64(oss, std::get<1>(tup));
         person.Goto(std::get<2>(tup));
-        WriteString(oss, person[PERSON_FIRSTNAME].string());
-        WriteString(oss, person[PERSON_LASTNAME].string());
+        WriteStringField(oss, person, PERSON_FIRSTNAME);
+        WriteStringField(oss, person, PERSON_LASTNAME);
         WriteInt32(oss, 0 - std::get<0>(tup));
-        WriteString(oss, person[PERSON_GENDER].string());
-        auto place = txn.GetVertexIterator(person[PERSON_PLACE].integer());
-        WriteString(oss, place[PLACE_NAME].string());
-        if (++res_count == res_size) break;
+        WriteStringField(oss, person, PERSON_GENDER);
+        WriteString(oss, dimensions.Name(Vertex<PERSON>::Get<PERSON_PLACE>(person)));
     }
     response = oss.str();
     return true;
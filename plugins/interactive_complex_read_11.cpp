@@ -4,11 +4,10 @@
 #include "lgraph/lgraph.h"
 #include "snb_common.h"
 #include "snb_constants.h"
-#include "tsl/hopscotch_map.h"
-#include "tsl/hopscotch_set.h"
 
 extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std::string& response) {
     constexpr size_t limit_results = 10;
+    ArenaScope arena("interactive_complex_read_11");
     std::string input = lgraph_api::base64::Decode(request);
     std::stringstream iss(input);
     int64_t person_id = ReadInt64(iss);
@@ -16,13 +15,13 @@ extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std
     int32_t year = ReadInt32(iss);
 
     auto txn = db.CreateReadTxn();
-    tsl::hopscotch_set<int64_t> visited;
+    ArenaHashSet<int64_t> visited;
     auto person = txn.GetVertexByUniqueIndex(PERSON, PERSON_ID, lgraph_api::FieldData::Int64(person_id));
     auto person_out_friends = lgraph_api::LabeledOutEdgeIterator(person, KNOWS);
     auto person_in_friends = lgraph_api::LabeledInEdgeIterator(person, KNOWS);
-    std::vector<int64_t> curr_frontier({person.GetId()});
+    ArenaVector<int64_t> curr_frontier({person.GetId()});
     for (int hop = 0; hop < 2; hop++) {
-        std::vector<int64_t> next_frontier;
+        ArenaVector<int64_t> next_frontier;
         for (auto vid : curr_frontier) {
             person.Goto(vid);
             for (person_out_friends.Reset(person, KNOWS); person_out_friends.IsValid(); person_out_friends.Next()) {
@@ -51,31 +50,33 @@ extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std
         auto iit = txn.GetVertexIndexIterator(PLACE, PLACE_NAME, fd, fd);
         while (iit.IsValid()) {
             country.Goto(iit.GetVid());
-            if (country[PLACE_TYPE].string() == "country") break;
+            if (StringEquals(country, PLACE_TYPE, "country")) break;
             iit.Next();
         }
     }
-    tsl::hopscotch_map<int64_t, std::string> organisation_info;
+    auto& dimensions = Dimensions::Get(txn);
+    ArenaVector<int64_t> friends(visited.begin(), visited.end());
+    std::sort(friends.begin(), friends.end());
+    // workInCountry in-edges come ordered by workFrom and then by person, so each run of equal workFrom is merged
+    // with the sorted friend list, and no later run can outrank a full result
     std::vector<std::tuple<int32_t, int64_t, std::string, std::string, std::string>> result;
-    for (auto country_organisations = lgraph_api::LabeledInEdgeIterator(country, ORGANISATIONISLOCATEDIN);
-         country_organisations.IsValid(); country_organisations.Next()) {
-        auto company_vid = country_organisations.GetSrc();
-        auto company = txn.GetVertexIterator(company_vid);
-        for (auto person_work_exps = lgraph_api::LabeledInEdgeIterator(company, WORKAT); person_work_exps.IsValid();
-             person_work_exps.Next()) {
-            auto person_vid0 = person_work_exps.GetSrc();
-            int32_t work_from_year = person_work_exps[WORKAT_WORKFROM].integer();
-            if (visited.contains(person_vid0) && work_from_year < year) {
-                if (!organisation_info.contains(company_vid)) {
-                    organisation_info.emplace(company_vid, company[ORGANISATION_NAME].string());
-                }
-                auto person0 = txn.GetVertexIterator(person_vid0);
-                auto person_id0 = person0[PERSON_ID].AsInt64();
-                auto person_first_name = person0[PERSON_FIRSTNAME].string();
-                auto person_last_name = person0[PERSON_LASTNAME].string();
-                result.emplace_back(0 - work_from_year, 0 - person_id0, organisation_info[company_vid],
-                                    person_first_name, person_last_name);
-            }
+    auto country_workers = lgraph_api::LabeledInEdgeIterator(country, WORKINCOUNTRY);
+    while (country_workers.IsValid() && result.size() < limit_results) {
+        int64_t work_from_year = Edge<WORKINCOUNTRY>::Get<WORKINCOUNTRY_WORKFROM>(country_workers);
+        if (work_from_year >= year) break;
+        auto friend_it = friends.begin();
+        for (; country_workers.IsValid(); country_workers.Next()) {
+            if (Edge<WORKINCOUNTRY>::Get<WORKINCOUNTRY_WORKFROM>(country_workers) != work_from_year) break;
+            auto person_vid0 = country_workers.GetSrc();
+            friend_it = GallopLowerBound(friend_it, friends.end(), person_vid0);
+            if (friend_it == friends.end() || *friend_it != person_vid0) continue;
+            auto person0 = txn.GetVertexIterator(person_vid0);
+            auto person_id0 = person0[PERSON_ID].AsInt64();
+            auto person_first_name = Vertex<PERSON>::Get<PERSON_FIRSTNAME>(person0);
+            auto person_last_name = Vertex<PERSON>::Get<PERSON_LASTNAME>(person0);
+            result.emplace_back(0 - work_from_year, 0 - person_id0,
+                                dimensions.Name(Edge<WORKINCOUNTRY>::Get<WORKINCOUNTRY_ORGANISATION>(country_workers)),
+                                person_first_name, person_last_name);
         }
     }
     std::sort(result.begin(), result.end(),
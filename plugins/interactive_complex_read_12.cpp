@@ -1,4 +1,4 @@
-#include <set>
+#include <algorithm>
 #include <tuple>
 
 #include "lgraph/lgraph.h"
@@ -12,9 +12,84 @@ using namespace lgraph_api;
 
 constexpr int worker_num = 4;
 
+// The closure of the isSubclassOf hierarchy over the tags and tagclasses of Dimensions, built once per process and
+// shared read-only by all calls.
+class TagClassHierarchy {
+    const Dimensions& dimensions_;
+    tsl::hopscotch_map<std::string, size_t> tagclass_index_;
+    std::vector<int64_t> tag_vids_;
+    // bitmask of the tagclasses each tag (transitively) belongs to, num_words_ words per tag
+    std::vector<uint64_t> tag_ancestors_;
+    size_t num_words_;
+    bool dense_;
+
+   public:
+    explicit TagClassHierarchy(const Dimensions& dimensions) : dimensions_(dimensions) {
+        tsl::hopscotch_map<int64_t, size_t> tagclass_vid_index;
+        std::vector<int64_t> tagclass_parents;
+        for (auto& entry : dimensions.Entries()) {
+            if (entry.label != TAGCLASS) continue;
+            tagclass_vid_index.emplace(entry.vid, tagclass_parents.size());
+            tagclass_index_.emplace(entry.name, tagclass_parents.size());
+            tagclass_parents.emplace_back(entry.parent);
+        }
+        num_words_ = (tagclass_parents.size() + 63) / 64;
+        std::vector<uint64_t> tagclass_ancestors(tagclass_parents.size() * num_words_, 0);
+        for (size_t i = 0; i < tagclass_parents.size(); i++) {
+            uint64_t* mask = &tagclass_ancestors[i * num_words_];
+            // isSubclassOf is a tree, so the ancestors of a tagclass are exactly its parent chain
+            for (size_t j = i; true;) {
+                mask[j / 64] |= uint64_t(1) << (j % 64);
+                auto it = tagclass_vid_index.find(tagclass_parents[j]);
+                if (it == tagclass_vid_index.end() || it->second == i) break;
+                j = it->second;
+            }
+        }
+        // entries are in vid order, so tag_vids_ is sorted
+        for (auto& entry : dimensions.Entries()) {
+            if (entry.label != TAG) continue;
+            tag_vids_.emplace_back(entry.vid);
+            tag_ancestors_.resize(tag_ancestors_.size() + num_words_, 0);
+            auto it = tagclass_vid_index.find(entry.parent);
+            if (it == tagclass_vid_index.end()) continue;
+            std::copy_n(&tagclass_ancestors[it->second * num_words_], num_words_,
+                        &tag_ancestors_[tag_ancestors_.size() - num_words_]);
+        }
+        dense_ = !tag_vids_.empty() && tag_vids_.back() - tag_vids_.front() + 1 == (int64_t)tag_vids_.size();
+    }
+
+    // returns the index of the tagclass with the given name, or -1 if there is none
+    int64_t FindTagClass(const std::string& name) const {
+        auto it = tagclass_index_.find(name);
+        return it == tagclass_index_.end() ? -1 : (int64_t)it->second;
+    }
+
+    // returns the position of the tag in tag_vids_, or -1 if the vid is not a tag
+    int64_t FindTag(int64_t tag_vid) const {
+        if (dense_) {
+            int64_t pos = tag_vid - tag_vids_.front();
+            return (pos >= 0 && pos < (int64_t)tag_vids_.size()) ? pos : -1;
+        }
+        auto it = std::lower_bound(tag_vids_.begin(), tag_vids_.end(), tag_vid);
+        return (it != tag_vids_.end() && *it == tag_vid) ? it - tag_vids_.begin() : -1;
+    }
+
+    bool IsTagOfClass(int64_t tag_vid, size_t tagclass) const {
+        int64_t pos = FindTag(tag_vid);
+        if (pos == -1) return false;
+        return (tag_ancestors_[pos * num_words_ + tagclass / 64] >> (tagclass % 64)) & 1;
+    }
+
+    const std::string& TagName(int64_t tag_vid) const { return dimensions_.Name(tag_vid); }
+};
+
+constexpr size_t limit_results = 20;
+
+// (-count, person id, tag vids, person vid)
+using Candidates = TopK<std::tuple<int32_t, int64_t, std::vector<int64_t>, int64_t>, limit_results>;
+
 void ProcessPersonComments(lgraph_api::VertexIterator& person, lgraph_api::VertexIterator& comment,
-                           std::set<std::tuple<int32_t, int64_t, std::vector<int64_t>, int64_t>>& candidates,
-                           const tsl::hopscotch_map<int64_t, std::string>& tag_info, const size_t limit_results) {
+                           Candidates& candidates, const TagClassHierarchy& hierarchy, const size_t tagclass) {
     int32_t count = 0;
     tsl::hopscotch_set<int64_t> tag_set;
     auto post_tags = lgraph_api::LabeledOutEdgeIterator(comment, POSTHASTAG);
@@ -27,7 +102,7 @@ void ProcessPersonComments(lgraph_api::VertexIterator& person, lgraph_api::Verte
         bool ok = false;
         for (post_tags.Reset(post_vid, POSTHASTAG); post_tags.IsValid(); post_tags.Next()) {
             int64_t tag_vid = post_tags.GetDst();
-            if (tag_info.find(tag_vid) != tag_info.end()) {
+            if (hierarchy.IsTagOfClass(tag_vid, tagclass)) {
                 tag_set.emplace(tag_vid);
                 ok = true;
             }
@@ -35,63 +110,26 @@ void ProcessPersonComments(lgraph_api::VertexIterator& person, lgraph_api::Verte
         if (ok) count++;
     }
     if (count == 0) return;
-    int64_t person_id = -1;
-    if (candidates.size() >= limit_results) {
-        auto& candidate = *candidates.rbegin();
-        if (0 - count > std::get<0>(candidate)) return;
-        if (0 - count == std::get<0>(candidate)) {
-            person_id = person[PERSON_ID].integer();
-            if (person_id > std::get<1>(candidate)) return;
-        }
-    }
-    if (person_id == -1) person_id = person[PERSON_ID].integer();
-    std::vector<int64_t> tag_list;
-    for (auto tag_vid : tag_set) {
-        tag_list.emplace_back(tag_vid);
-    }
-    candidates.emplace(0 - count, person_id, tag_list, person.GetId());
-    if (candidates.size() > limit_results) {
-        candidates.erase(--candidates.end());
-    }
+    candidates.Offer(0 - count, [&]() {
+        std::vector<int64_t> tag_list(tag_set.begin(), tag_set.end());
+        return std::make_tuple(0 - count, Vertex<PERSON>::Get<PERSON_ID>(person), std::move(tag_list), person.GetId());
+    });
 }
 
 extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std::string& response) {
-    constexpr size_t limit_results = 20;
     std::string input = lgraph_api::base64::Decode(request);
     std::stringstream iss(input);
     int64_t person_id = ReadInt64(iss);
     std::string tagclass_name = ReadString(iss);
 
     auto txn = db.CreateReadTxn();
-    auto tagclass = txn.GetVertexByUniqueIndex(TAGCLASS, TAGCLASS_NAME, lgraph_api::FieldData::String(tagclass_name));
-    int64_t start_vid = tagclass.GetId();
-    tsl::hopscotch_set<int64_t> visited({start_vid});
-    tsl::hopscotch_map<int64_t, std::string> tag_info;
-    std::vector<int64_t> curr_frontier({start_vid});
-    auto tagclass_subclasses = lgraph_api::LabeledInEdgeIterator(tagclass, ISSUBCLASSOF);
-    auto tagclass_tags = lgraph_api::LabeledInEdgeIterator(tagclass, HASTYPE);
-    auto tag = txn.GetVertexIterator();
-    while (!curr_frontier.empty()) {
-        std::vector<int64_t> next_frontier;
-        for (auto tagclass_vid : curr_frontier) {
-            tagclass.Goto(tagclass_vid);
-            for (tagclass_subclasses.Reset(tagclass, ISSUBCLASSOF); tagclass_subclasses.IsValid();
-                 tagclass_subclasses.Next()) {
-                int64_t tagclass_vid = tagclass_subclasses.GetSrc();
-                if (visited.find(tagclass_vid) == visited.end()) {
-                    visited.emplace(tagclass_vid);
-                    next_frontier.emplace_back(tagclass_vid);
-                }
-            }
-            for (tagclass_tags.Reset(tagclass, HASTYPE); tagclass_tags.IsValid(); tagclass_tags.Next()) {
-                int64_t tag_vid = tagclass_tags.GetSrc();
-                if (tag_info.find(tag_vid) == tag_info.end()) {
-                    tag.Goto(tag_vid);
-                    tag_info.emplace(tag_vid, tag[TAG_NAME].string());
-                }
-            }
-        }
-        curr_frontier.swap(next_frontier);
+    static const TagClassHierarchy hierarchy(Dimensions::Get(txn));
+    int64_t tagclass = hierarchy.FindTagClass(tagclass_name);
+    if (tagclass == -1) {
+        std::stringstream oss;
+        WriteInt16(oss, 0);
+        response = oss.str();
+        return true;
     }
     std::vector<int64_t> friends;
     auto person = txn.GetVertexByUniqueIndex(PERSON, PERSON_ID, lgraph_api::FieldData::Int64(person_id));
@@ -104,33 +142,27 @@ extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std
         friends.emplace_back(person_friends.GetSrc());
     }
     // result type
-    using result_type = std::set<std::tuple<int32_t, int64_t, std::vector<int64_t>, int64_t>>;
     static std::vector<Worker> workers(worker_num);
-    auto candidates = ForEachVertex<result_type>(
+    auto candidates = ForEachVertex<Candidates>(
         db, txn, workers, friends,
-        [&](Transaction& t, VertexIterator& vit, result_type& local) {
+        [&](Transaction& t, VertexIterator& vit, Candidates& local) {
             auto comment = t.GetVertexIterator();
-            ProcessPersonComments(vit, comment, local, tag_info, limit_results);
+            ProcessPersonComments(vit, comment, local, hierarchy, tagclass);
         },
-        [&](const result_type& local, result_type& res) {
-            for (auto& r : local) res.emplace(r);
-        });
-    int res_size = std::min(candidates.size(), limit_results);
-    int res_count = 0;
+        [&](const Candidates& local, Candidates& res) { res.Merge(local); });
     std::stringstream oss;
-    WriteInt16(oss, res_size);
-    for (auto& tup : candidates) {
+    WriteInt16(oss, candidates.size());
+    for (auto& tup : candidates.Sorted()) {
         WriteInt64(oss, std::get<1>(tup));
         person.Goto(std::get<3>(tup));
-        WriteString(oss, person[PERSON_FIRSTNAME].string());
-        WriteString(oss, person[PERSON_LASTNAME].string());
+        WriteStringField(oss, person, PERSON_FIRSTNAME);
+        WriteStringField(oss, person, PERSON_LASTNAME);
         auto& tag_list = std::get<2>(tup);
         WriteInt16(oss, tag_list.size());
         for (auto tag_vid : tag_list) {
-            WriteString(oss, tag_info[tag_vid]);
+            WriteString(oss, hierarchy.TagName(tag_vid));
         }
         WriteInt32(oss, 0 - std::get<0>(tup));
-        if (++res_count == res_size) break;
     }
     response = oss.str();
     return true;
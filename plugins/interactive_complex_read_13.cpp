@@ -1,18 +1,17 @@
 #include "lgraph/lgraph.h"
 #include "snb_common.h"
 #include "snb_constants.h"
-#include "tsl/hopscotch_map.h"
 
 int32_t CalcShortestPathLength(lgraph_api::Transaction& txn, const int64_t start_vid, const int64_t end_vid) {
     if (start_vid == end_vid) {
         return 0;
     }
-    tsl::hopscotch_map<int64_t, int64_t> parent({{start_vid, start_vid}});
-    tsl::hopscotch_map<int64_t, int64_t> child({{end_vid, end_vid}});
-    std::vector<int64_t> forward_q({start_vid});
-    std::vector<int64_t> backward_q({end_vid});
+    ArenaHashMap<int64_t, int64_t> parent({{start_vid, start_vid}});
+    ArenaHashMap<int64_t, int64_t> child({{end_vid, end_vid}});
+    ArenaVector<int64_t> forward_q({start_vid});
+    ArenaVector<int64_t> backward_q({end_vid});
     for (int hop = 0; !forward_q.empty() && !backward_q.empty(); hop++) {
-        std::vector<int64_t> next_q;
+        ArenaVector<int64_t> next_q;
         if (forward_q.size() <= backward_q.size()) {
             for (int64_t person_vid : forward_q) {
                 for (auto person_friends = lgraph_api::LabeledOutEdgeIterator(txn, person_vid, KNOWS);
@@ -70,6 +69,7 @@ int32_t CalcShortestPathLength(lgraph_api::Transaction& txn, const int64_t start
 
 extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std::string& response) {
     constexpr size_t limit_results = 20;
+    ArenaScope arena("interactive_complex_read_13");
 
     std::string input = lgraph_api::base64::Decode(request);
     std::stringstream iss(input);
@@ -3,19 +3,18 @@
 #include "lgraph/lgraph.h"
 #include "snb_common.h"
 #include "snb_constants.h"
-#include "tsl/hopscotch_map.h"
 
 inline int64_t FetchPersonId(int64_t person_vid, lgraph_api::VertexIterator& person,
-                             tsl::hopscotch_map<int64_t, int64_t>& person_id_map) {
+                             ArenaHashMap<int64_t, int64_t>& person_id_map) {
     auto it = person_id_map.find(person_vid);
     if (it != person_id_map.end()) return it->second;
     person.Goto(person_vid);
-    int64_t person_id = person[PERSON_ID].integer();
+    int64_t person_id = Vertex<PERSON>::Get<PERSON_ID>(person);
     person_id_map[person_vid] = person_id;
     return person_id;
 }
 
-void EnumeratePartialPaths(lgraph_api::Transaction& txn, const tsl::hopscotch_map<int64_t, int>& hop_info,
+void EnumeratePartialPaths(lgraph_api::Transaction& txn, const ArenaHashMap<int64_t, int>& hop_info,
                            std::vector<std::pair<double, std::vector<int64_t> > >& paths, const int64_t person_vid,
                            const int depth, const double path_weight, std::vector<int64_t>& path, const bool reverse) {
     path.emplace_back(person_vid);
@@ -25,7 +24,7 @@ void EnumeratePartialPaths(lgraph_api::Transaction& txn, const tsl::hopscotch_ma
             int64_t friend_vid = person_friends.GetDst();
             auto it = hop_info.find(friend_vid);
             if (it != hop_info.end() && it->second == depth - 1) {
-                double weight = person_friends[KNOWS_WEIGHT].real();
+                double weight = Edge<KNOWS>::Get<KNOWS_WEIGHT>(person_friends);
                 EnumeratePartialPaths(txn, hop_info, paths, friend_vid, depth - 1, path_weight + weight, path, reverse);
             }
         }
@@ -34,7 +33,7 @@ void EnumeratePartialPaths(lgraph_api::Transaction& txn, const tsl::hopscotch_ma
             int64_t friend_vid = person_friends.GetSrc();
             auto it = hop_info.find(friend_vid);
             if (it != hop_info.end() && it->second == depth - 1) {
-                double weight = person_friends[KNOWS_WEIGHT].real();
+                double weight = Edge<KNOWS>::Get<KNOWS_WEIGHT>(person_friends);
                 EnumeratePartialPaths(txn, hop_info, paths, friend_vid, depth - 1, path_weight + weight, path, reverse);
             }
         }
@@ -57,26 +56,26 @@ void EnumerateAllShortestPaths(lgraph_api::Transaction& txn, const int64_t start
         // num_paths, path_length, [vids], weight
         WriteInt32(oss, 1);
         WriteInt32(oss, 0);
-        WriteInt64(oss, person[PERSON_ID].integer());
+        WriteInt64(oss, Vertex<PERSON>::Get<PERSON_ID>(person));
         WriteDouble(oss, 0.0);
         return;
     }
-    tsl::hopscotch_map<int64_t, int> parent({{start_vid, 0}});
-    tsl::hopscotch_map<int64_t, int> child({{end_vid, 0}});
-    std::vector<int64_t> forward_q({start_vid});
-    std::vector<int64_t> backward_q({end_vid});
+    ArenaHashMap<int64_t, int> parent({{start_vid, 0}});
+    ArenaHashMap<int64_t, int> child({{end_vid, 0}});
+    ArenaVector<int64_t> forward_q({start_vid});
+    ArenaVector<int64_t> backward_q({end_vid});
     int fhop = 0;
     int bhop = 0;
-    std::vector<std::tuple<int64_t, int64_t, double> > hits;
+    ArenaVector<std::tuple<int64_t, int64_t, double> > hits;
     for (int hop = 0; !forward_q.empty() && !backward_q.empty() && hits.empty(); hop++) {
-        std::vector<int64_t> next_q;
+        ArenaVector<int64_t> next_q;
         if (forward_q.size() <= backward_q.size()) {
             fhop++;
             for (int64_t person_vid : forward_q) {
                 for (auto person_friends = lgraph_api::LabeledOutEdgeIterator(txn, person_vid, KNOWS);
                      person_friends.IsValid(); person_friends.Next()) {
                     int64_t friend_vid = person_friends.GetDst();
-                    double weight = person_friends[KNOWS_WEIGHT].real();
+                    double weight = Edge<KNOWS>::Get<KNOWS_WEIGHT>(person_friends);
                     if (child.find(friend_vid) != child.end()) {
                         hits.emplace_back(person_vid, friend_vid, weight);
                     } else {
@@ -90,7 +89,7 @@ void EnumerateAllShortestPaths(lgraph_api::Transaction& txn, const int64_t start
                 for (auto person_friends = lgraph_api::LabeledInEdgeIterator(txn, person_vid, KNOWS);
                      person_friends.IsValid(); person_friends.Next()) {
                     int64_t friend_vid = person_friends.GetSrc();
-                    double weight = person_friends[KNOWS_WEIGHT].real();
+                    double weight = Edge<KNOWS>::Get<KNOWS_WEIGHT>(person_friends);
                     if (child.find(friend_vid) != child.end()) {
                         hits.emplace_back(person_vid, friend_vid, weight);
                     } else {
@@ -110,7 +109,7 @@ void EnumerateAllShortestPaths(lgraph_api::Transaction& txn, const int64_t start
                 for (auto person_friends = lgraph_api::LabeledOutEdgeIterator(txn, person_vid, KNOWS);
                      person_friends.IsValid(); person_friends.Next()) {
                     int64_t friend_vid = person_friends.GetDst();
-                    double weight = person_friends[KNOWS_WEIGHT].real();
+                    double weight = Edge<KNOWS>::Get<KNOWS_WEIGHT>(person_friends);
                     if (parent.find(friend_vid) != parent.end()) {
                         hits.emplace_back(friend_vid, person_vid, weight);
                     } else {
@@ -124,7 +123,7 @@ void EnumerateAllShortestPaths(lgraph_api::Transaction& txn, const int64_t start
                 for (auto person_friends = lgraph_api::LabeledInEdgeIterator(txn, person_vid, KNOWS);
                      person_friends.IsValid(); person_friends.Next()) {
                     int64_t friend_vid = person_friends.GetSrc();
-                    double weight = person_friends[KNOWS_WEIGHT].real();
+                    double weight = Edge<KNOWS>::Get<KNOWS_WEIGHT>(person_friends);
                     if (parent.find(friend_vid) != parent.end()) {
                         hits.emplace_back(friend_vid, person_vid, weight);
                     } else {
@@ -161,7 +160,7 @@ void EnumerateAllShortestPaths(lgraph_api::Transaction& txn, const int64_t start
             }
         }
     }
-    tsl::hopscotch_map<int64_t, int64_t> person_info;
+    ArenaHashMap<int64_t, int64_t> person_info;
     auto person = txn.GetVertexIterator();
     for (auto it = paths.rbegin(); it != paths.rend(); it++) {
         for (auto& vid : it->second) {
@@ -183,6 +182,7 @@ void EnumerateAllShortestPaths(lgraph_api::Transaction& txn, const int64_t start
 
 extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std::string& response) {
     constexpr size_t limit_results = 20;
+    ArenaScope arena("interactive_complex_read_14");
 
     std::string input = lgraph_api::base64::Decode(request);
     std::stringstream iss(input);
@@ -1,84 +1,41 @@
-#include <set>
 #include <tuple>
 
 #include "lgraph/lgraph.h"
 #include "snb_common.h"
 #include "snb_constants.h"
 
-void ProcessFriendMessages(
-    lgraph_api::VertexIterator& person_friend, lgraph_api::VertexIterator& message,
-    std::set<std::tuple<int64_t, int64_t, int64_t, std::string, std::string, std::string> >& candidates,
-    const int64_t max_date, const size_t limit_results) {
+constexpr size_t limit_results = 20;
+
+// (-creationDate, message id, friend vid, message vid)
+using Candidates = TopK<std::tuple<int64_t, int64_t, int64_t, int64_t>, limit_results>;
+
+void ProcessFriendMessages(lgraph_api::VertexIterator& person_friend, lgraph_api::VertexIterator& message,
+                           Candidates& candidates, const int64_t max_date) {
     for (auto friend_posts = lgraph_api::LabeledInEdgeIterator(person_friend, POSTHASCREATOR); friend_posts.IsValid();
          friend_posts.Next()) {
-        int64_t creation_date = friend_posts[POSTHASCREATOR_CREATIONDATE].integer();
+        int64_t creation_date = Edge<POSTHASCREATOR>::Get<POSTHASCREATOR_CREATIONDATE>(friend_posts);
         if (creation_date > max_date) continue;
-        int64_t message_vid = -1;
-        int64_t message_id;
-        if (candidates.size() >= limit_results) {
-            auto& candidate = *candidates.rbegin();
-            if (0 - creation_date > std::get<0>(candidate)) continue;
-            if (0 - creation_date == std::get<0>(candidate)) {
-                message_vid = friend_posts.GetSrc();
-                message.Goto(message_vid);
-                message_id = message[POST_ID].integer();
-                if (message_id > std::get<1>(candidate)) continue;
-            }
-        }
-        if (message_vid == -1) {
-            message_vid = friend_posts.GetSrc();
+        candidates.Offer(0 - creation_date, [&]() {
+            int64_t message_vid = friend_posts.GetSrc();
             message.Goto(message_vid);
-            message_id = message[POST_ID].integer();
-        }
-        std::string message_content;
-        auto content = message[POST_CONTENT];
-        if (!content.is_null()) {
-            message_content = content.string();
-        } else {
-            message_content = message[POST_IMAGEFILE].string();
-        }
-        candidates.emplace(0 - creation_date, message_id, person_friend[PERSON_ID].integer(),
-                           person_friend[PERSON_FIRSTNAME].string(), person_friend[PERSON_LASTNAME].string(),
-                           message_content);
-        if (candidates.size() > limit_results) {
-            candidates.erase(--candidates.end());
-        }
+            return std::make_tuple(0 - creation_date, Vertex<POST>::Get<POST_ID>(message), person_friend.GetId(),
+                                   message_vid);
+        });
     }
     for (auto friend_comments = lgraph_api::LabeledInEdgeIterator(person_friend, COMMENTHASCREATOR);
          friend_comments.IsValid(); friend_comments.Next()) {
-        int64_t creation_date = friend_comments[COMMENTHASCREATOR_CREATIONDATE].integer();
+        int64_t creation_date = Edge<COMMENTHASCREATOR>::Get<COMMENTHASCREATOR_CREATIONDATE>(friend_comments);
         if (creation_date > max_date) continue;
-        int64_t message_vid = -1;
-        int64_t message_id;
-        if (candidates.size() >= limit_results) {
-            auto& candidate = *candidates.rbegin();
-            if (0 - creation_date > std::get<0>(candidate)) continue;
-            if (0 - creation_date == std::get<0>(candidate)) {
-                message_vid = friend_comments.GetSrc();
-                message.Goto(message_vid);
-                message_id = message[COMMENT_ID].integer();
-                if (message_id > std::get<1>(candidate)) continue;
-            }
-        }
-        if (message_vid == -1) {
-            message_vid = friend_comments.GetSrc();
+        candidates.Offer(0 - creation_date, [&]() {
+            int64_t message_vid = friend_comments.GetSrc();
             message.Goto(message_vid);
-            message_id = message[COMMENT_ID].integer();
-        }
-        std::string message_content;
-        message_content = message[COMMENT_CONTENT].string();
-        candidates.emplace(0 - creation_date, message_id, person_friend[PERSON_ID].integer(),
-                           person_friend[PERSON_FIRSTNAME].string(), person_friend[PERSON_LASTNAME].string(),
-                           message_content);
-        if (candidates.size() > limit_results) {
-            candidates.erase(--candidates.end());
-        }
+            return std::make_tuple(0 - creation_date, Vertex<COMMENT>::Get<COMMENT_ID>(message), person_friend.GetId(),
+                                   message_vid);
+        });
     }
 }
 
 extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std::string& response) {
-    constexpr size_t limit_results = 20;
-
     std::string input = lgraph_api::base64::Decode(request);
     std::stringstream iss(input);
     int64_t person_id = ReadInt64(iss);
@@ -88,26 +45,37 @@ extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std
     auto person = txn.GetVertexByUniqueIndex(PERSON, PERSON_ID, lgraph_api::FieldData::Int64(person_id));
     auto person_friend = txn.GetVertexIterator();
     auto message = txn.GetVertexIterator();
-    std::set<std::tuple<int64_t, int64_t, int64_t, std::string, std::string, std::string> > candidates;
+    Candidates candidates;
     for (auto person_friends = lgraph_api::LabeledOutEdgeIterator(person, KNOWS); person_friends.IsValid();
          person_friends.Next()) {
         person_friend.Goto(person_friends.GetDst());
-        ProcessFriendMessages(person_friend, message, candidates, max_date, limit_results);
+        ProcessFriendMessages(person_friend, message, candidates, max_date);
     }
     for (auto person_friends = lgraph_api::LabeledInEdgeIterator(person, KNOWS); person_friends.IsValid();
          person_friends.Next()) {
         person_friend.Goto(person_friends.GetSrc());
-        ProcessFriendMessages(person_friend, message, candidates, max_date, limit_results);
+        ProcessFriendMessages(person_friend, message, candidates, max_date);
     }
     // output results
     std::stringstream oss;
     WriteInt16(oss, candidates.size());
-    for (auto& tup : candidates) {
-        WriteInt64(oss, std::get<2>(tup));
-        WriteString(oss, std::get<3>(tup));
-        WriteString(oss, std::get<4>(tup));
+    for (auto& tup : candidates.Sorted()) {
+        person_friend.Goto(std::get<2>(tup));
+        WriteInt64(oss, Vertex<PERSON>::Get<PERSON_ID>(person_friend));
+        WriteStringField(oss, person_friend, PERSON_FIRSTNAME);
+        WriteStringField(oss, person_friend, PERSON_LASTNAME);
         WriteInt64(oss, std::get<1>(tup));
-        WriteString(oss, std::get<5>(tup));
+        message.Goto(std::get<3>(tup));
+        if (message.GetLabelId() == POST) {
+            auto content = message[POST_CONTENT];
+            if (!content.is_null()) {
+                WriteString(oss, content.string());
+            } else {
+                WriteStringField(oss, message, POST_IMAGEFILE);
+            }
+        } else /* COMMENT */ {
+            WriteStringField(oss, message, COMMENT_CONTENT);
+        }
         WriteInt64(oss, 0 - std::get<0>(tup));
     }
     response = oss.str();
@@ -1,14 +1,12 @@
-#include <set>
 #include <tuple>
 
 #include "lgraph/lgraph.h"
 #include "snb_common.h"
 #include "snb_constants.h"
-#include "tsl/hopscotch_map.h"
-#include "tsl/hopscotch_set.h"
 
 extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std::string& response) {
     constexpr size_t limit_results = 20;
+    ArenaScope arena("interactive_complex_read_3");
     std::string input = lgraph_api::base64::Decode(request);
     std::stringstream iss(input);
     int64_t person_id = ReadInt64(iss);
@@ -26,8 +24,10 @@ extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std
         start_vid = iit.GetVid();
     }
     auto place = txn.GetVertexIterator();
-    std::vector<std::pair<int64_t, int8_t> > message_vids;
-    tsl::hopscotch_set<int64_t> xy_person_vids;
+    // messages located in country x (side 0) or country y (side 1) during the period
+    ArenaVector<int64_t> post_vids, comment_vids;
+    ArenaVector<int8_t> post_sides, comment_sides;
+    ArenaHashSet<int64_t> xy_person_vids;
     int64_t country_x_vid = -1;
     {
         auto fd = lgraph_api::FieldData::String(country_x_name);
@@ -35,10 +35,10 @@ extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std
         while (iit.IsValid()) {
             country_x_vid = iit.GetVid();
             place.Goto(country_x_vid);
-            if (place[PLACE_TYPE].string() == "country") break;
+            if (StringEquals(place, PLACE_TYPE, "country")) break;
             iit.Next();
         }
-        std::vector<int64_t> city_vids;
+        ArenaVector<int64_t> city_vids;
         for (auto country_cities = lgraph_api::LabeledInEdgeIterator(txn, country_x_vid, ISPARTOF);
              country_cities.IsValid(); country_cities.Next()) {
             int64_t city_vid = country_cities.GetSrc();
@@ -54,17 +54,19 @@ extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std
         }
         for (auto country_posts = lgraph_api::LabeledInEdgeIterator(txn, country_x_vid, POSTISLOCATEDIN);
              country_posts.IsValid(); country_posts.Next()) {
-            int64_t creation_date = country_posts[POSTISLOCATEDIN_CREATIONDATE].integer();
+            int64_t creation_date = Edge<POSTISLOCATEDIN>::Get<POSTISLOCATEDIN_CREATIONDATE>(country_posts);
             if (creation_date < start_date || creation_date >= end_date) continue;
             int64_t post_vid = country_posts.GetSrc();
-            message_vids.emplace_back(post_vid, -1);
+            post_vids.emplace_back(post_vid);
+            post_sides.emplace_back(0);
         }
         for (auto country_comments = lgraph_api::LabeledInEdgeIterator(txn, country_x_vid, COMMENTISLOCATEDIN);
              country_comments.IsValid(); country_comments.Next()) {
-            int64_t creation_date = country_comments[COMMENTISLOCATEDIN_CREATIONDATE].integer();
+            int64_t creation_date = Edge<COMMENTISLOCATEDIN>::Get<COMMENTISLOCATEDIN_CREATIONDATE>(country_comments);
             if (creation_date < start_date || creation_date >= end_date) continue;
             int64_t comment_vid = country_comments.GetSrc();
-            message_vids.emplace_back(comment_vid, -2);
+            comment_vids.emplace_back(comment_vid);
+            comment_sides.emplace_back(0);
         }
     }
     int64_t country_y_vid = -1;
@@ -74,10 +76,10 @@ extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std
         while (iit.IsValid()) {
             country_y_vid = iit.GetVid();
             place.Goto(country_y_vid);
-            if (place[PLACE_TYPE].string() == "country") break;
+            if (StringEquals(place, PLACE_TYPE, "country")) break;
             iit.Next();
         }
-        std::vector<int64_t> city_vids;
+        ArenaVector<int64_t> city_vids;
         for (auto country_cities = lgraph_api::LabeledInEdgeIterator(txn, country_y_vid, ISPARTOF);
              country_cities.IsValid(); country_cities.Next()) {
             int64_t city_vid = country_cities.GetSrc();
@@ -93,26 +95,28 @@ extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std
         }
         for (auto country_posts = lgraph_api::LabeledInEdgeIterator(txn, country_y_vid, POSTISLOCATEDIN);
              country_posts.IsValid(); country_posts.Next()) {
-            int64_t creation_date = country_posts[POSTISLOCATEDIN_CREATIONDATE].integer();
+            int64_t creation_date = Edge<POSTISLOCATEDIN>::Get<POSTISLOCATEDIN_CREATIONDATE>(country_posts);
             if (creation_date < start_date || creation_date >= end_date) continue;
             int64_t post_vid = country_posts.GetSrc();
-            message_vids.emplace_back(post_vid, +1);
+            post_vids.emplace_back(post_vid);
+            post_sides.emplace_back(1);
         }
         for (auto country_comments = lgraph_api::LabeledInEdgeIterator(txn, country_y_vid, COMMENTISLOCATEDIN);
              country_comments.IsValid(); country_comments.Next()) {
-            int64_t creation_date = country_comments[COMMENTISLOCATEDIN_CREATIONDATE].integer();
+            int64_t creation_date = Edge<COMMENTISLOCATEDIN>::Get<COMMENTISLOCATEDIN_CREATIONDATE>(country_comments);
             if (creation_date < start_date || creation_date >= end_date) continue;
             int64_t comment_vid = country_comments.GetSrc();
-            message_vids.emplace_back(comment_vid, +2);
+            comment_vids.emplace_back(comment_vid);
+            comment_sides.emplace_back(1);
         }
     }
 
-    tsl::hopscotch_set<int64_t> visited({start_vid});
-    tsl::hopscotch_map<int64_t, std::tuple<int32_t, int32_t> > person_info;
+    ArenaHashSet<int64_t> visited({start_vid});
+    ArenaHashMap<int64_t, std::tuple<int32_t, int32_t> > person_info;
     auto person = txn.GetVertexIterator();
-    std::vector<int64_t> curr_frontier({start_vid});
+    ArenaVector<int64_t> curr_frontier({start_vid});
     for (int hop = 0; hop < 2; hop++) {
-        std::vector<int64_t> next_frontier;
+        ArenaVector<int64_t> next_frontier;
         for (auto vid : curr_frontier) {
             person.Goto(vid);
             for (auto person_friends = lgraph_api::LabeledOutEdgeIterator(person, KNOWS); person_friends.IsValid();
@@ -142,82 +146,41 @@ extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std
         curr_frontier.swap(next_frontier);
     }
 
-    std::sort(message_vids.begin(), message_vids.end());
-    auto message = txn.GetVertexIterator();
-    for (auto& p : message_vids) {
-        int64_t message_vid = p.first;
-        int8_t message_type = p.second;
-        message.Goto(message_vid);
-        switch (message_type) {
-            case -1: {
-                int64_t creator_vid = message[POST_CREATOR].integer();
-                auto it = person_info.find(creator_vid);
-                if (it != person_info.end()) {
-                    std::get<0>(it.value())++;
-                }
-                break;
-            }
-            case -2: {
-                int64_t creator_vid = message[COMMENT_CREATOR].integer();
-                auto it = person_info.find(creator_vid);
-                if (it != person_info.end()) {
-                    std::get<0>(it.value())++;
-                }
-                break;
-            }
-            case +1: {
-                int64_t creator_vid = message[POST_CREATOR].integer();
-                auto it = person_info.find(creator_vid);
-                if (it != person_info.end()) {
-                    std::get<1>(it.value())++;
-                }
-                break;
-            }
-            case +2: {
-                int64_t creator_vid = message[COMMENT_CREATOR].integer();
-                auto it = person_info.find(creator_vid);
-                if (it != person_info.end()) {
-                    std::get<1>(it.value())++;
-                }
-                break;
-            }
-            default:;
+    auto count_message = [&](int64_t creator_vid, int8_t side) {
+        auto it = person_info.find(creator_vid);
+        if (it == person_info.end()) return;
+        if (side == 0) {
+            std::get<0>(it.value())++;
+        } else {
+            std::get<1>(it.value())++;
         }
-    }
+    };
+    FetchVertices(txn, post_vids, {POST_CREATOR}, [&](size_t i, const std::vector<lgraph_api::FieldData>& values) {
+        count_message(VertexField<POST, POST_CREATOR>::Get(values[0]), post_sides[i]);
+    });
+    FetchVertices(txn, comment_vids, {COMMENT_CREATOR}, [&](size_t i, const std::vector<lgraph_api::FieldData>& values) {
+        count_message(VertexField<COMMENT, COMMENT_CREATOR>::Get(values[0]), comment_sides[i]);
+    });
 
-    std::set<std::tuple<int32_t, int64_t, int64_t> > candidates;
+    TopK<std::tuple<int32_t, int64_t, int64_t>, limit_results> candidates;
     for (auto it = person_info.begin(); it != person_info.end(); it++) {
         int32_t x_count, y_count;
         std::tie(x_count, y_count) = it->second;
         if (x_count == 0 || y_count == 0) continue;
         int64_t person_vid = it->first;
-        int64_t person_id = -1;
-        if (candidates.size() >= limit_results) {
-            auto& candidate = *candidates.rbegin();
-            if (0 - x_count - y_count > std::get<0>(candidate)) continue;
-            if (0 - x_count - y_count == std::get<0>(candidate)) {
-                person.Goto(person_vid);
-                person_id = person[PERSON_ID].integer();
-                if (person_id > std::get<1>(candidate)) continue;
-            }
-        }
-        if (person_id == -1) {
+        candidates.Offer(0 - x_count - y_count, [&]() {
             person.Goto(person_vid);
-            person_id = person[PERSON_ID].integer();
-        }
-        candidates.emplace(0 - x_count - y_count, person_id, person_vid);
-        if (candidates.size() > limit_results) {
-            candidates.erase(--candidates.end());
-        }
+            return std::make_tuple(0 - x_count - y_count, Vertex<PERSON>::Get<PERSON_ID>(person), person_vid);
+        });
     }
     // output results
     std::stringstream oss;
     WriteInt16(oss, candidates.size());
-    for (auto& tup : candidates) {
+    for (auto& tup : candidates.Sorted()) {
         WriteInt64(oss, std::get<1>(tup));
         person.Goto(std::get<2>(tup));
-        WriteString(oss, person[PERSON_FIRSTNAME].string());
-        WriteString(oss, person[PERSON_LASTNAME].string());
+        WriteStringField(oss, person, PERSON_FIRSTNAME);
+        WriteStringField(oss, person, PERSON_LASTNAME);
         int32_t x_count, y_count;
         std::tie(x_count, y_count) = person_info.find(std::get<2>(tup))->second;
         WriteInt32(oss, x_count);
@@ -1,16 +1,13 @@
-#include <set>
-
 #include "lgraph/lgraph.h"
 #include "snb_common.h"
 #include "snb_constants.h"
-#include "tsl/hopscotch_map.h"
 
 void ProcessPersonPosts(lgraph_api::VertexIterator& person, lgraph_api::VertexIterator& message,
-                        tsl::hopscotch_map<int64_t, std::pair<int64_t, int32_t> >& tag_stats,
+                        ArenaHashMap<int64_t, std::pair<int64_t, int32_t> >& tag_stats,
                         const int64_t start_date, const int64_t end_date) {
     for (auto person_posts = lgraph_api::LabeledInEdgeIterator(person, POSTHASCREATOR); person_posts.IsValid();
          person_posts.Next()) {
-        int64_t creation_date = person_posts[POSTHASCREATOR_CREATIONDATE].integer();
+        int64_t creation_date = Edge<POSTHASCREATOR>::Get<POSTHASCREATOR_CREATIONDATE>(person_posts);
         if (creation_date > end_date) continue;
         message.Goto(person_posts.GetSrc());
         for (auto message_tags = lgraph_api::LabeledOutEdgeIterator(message, POSTHASTAG); message_tags.IsValid();
@@ -29,6 +26,7 @@ void ProcessPersonPosts(lgraph_api::VertexIterator& person, lgraph_api::VertexIt
 
 extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std::string& response) {
     constexpr size_t limit_results = 10;
+    ArenaScope arena("interactive_complex_read_4");
 
     std::string input = lgraph_api::base64::Decode(request);
     std::stringstream iss(input);
@@ -41,7 +39,7 @@ extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std
     auto person = txn.GetVertexByUniqueIndex(PERSON, PERSON_ID, lgraph_api::FieldData::Int64(person_id));
     auto person_friend = txn.GetVertexIterator();
     auto message = txn.GetVertexIterator();
-    tsl::hopscotch_map<int64_t, std::pair<int64_t, int32_t> > tag_stats;
+    ArenaHashMap<int64_t, std::pair<int64_t, int32_t> > tag_stats;
     for (auto person_friends = lgraph_api::LabeledOutEdgeIterator(person, KNOWS); person_friends.IsValid();
          person_friends.Next()) {
         person_friend.Goto(person_friends.GetDst());
@@ -53,35 +51,18 @@ extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std
         ProcessPersonPosts(person_friend, message, tag_stats, start_date, end_date);
     }
 
-    std::set<std::pair<int32_t, std::string> > candidates;
-    auto tag = txn.GetVertexIterator();
+    TopK<std::pair<int32_t, std::string>, limit_results> candidates;
+    auto& dimensions = Dimensions::Get(txn);
     for (auto it = tag_stats.begin(); it != tag_stats.end(); it++) {
         if (it->second.first < start_date) continue;
         int64_t tag_vid = it->first;
-        auto post_count = it->second.second;
-        std::string tag_name;
-        if (candidates.size() >= limit_results) {
-            auto& candidate = *candidates.rbegin();
-            if (0 - post_count > std::get<0>(candidate)) continue;
-            if (0 - post_count == std::get<0>(candidate)) {
-                tag.Goto(tag_vid);
-                tag_name = tag[TAG_NAME].string();
-                if (tag_name > std::get<1>(candidate)) continue;
-            }
-        }
-        if (tag_name.empty()) {
-            tag.Goto(tag_vid);
-            tag_name = tag[TAG_NAME].string();
-        }
-        candidates.emplace(0 - post_count, tag_name);
-        if (candidates.size() > limit_results) {
-            candidates.erase(--candidates.end());
-        }
+        int32_t post_count = it->second.second;
+        candidates.Offer(0 - post_count, [&]() { return std::make_pair(0 - post_count, dimensions.Name(tag_vid)); });
     }
     // output results
     std::stringstream oss;
     WriteInt16(oss, candidates.size());
-    for (auto& tup : candidates) {
+    for (auto& tup : candidates.Sorted()) {
         WriteString(oss, std::get<1>(tup));
         WriteInt32(oss, 0 - std::get<0>(tup));
     }
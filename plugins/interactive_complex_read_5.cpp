@@ -1,4 +1,6 @@
-#include <set>
+#include <algorithm>
+#include <array>
+#include <memory>
 #include <tuple>
 
 #include "lgraph/lgraph.h"
@@ -6,33 +8,42 @@
 #include "snb_common.h"
 #include "snb_constants.h"
 #include "tsl/hopscotch_map.h"
-#include "tsl/hopscotch_set.h"
 
 using namespace lgraph_api;
 
 constexpr int worker_num = 4;
 
-void ProcessPersonPosts(lgraph_api::VertexIterator& person,
-                        std::pair<std::set<int64_t>, std::vector<std::tuple<int64_t, int32_t>>>& post_counts,
-                        const int64_t min_date) {
+constexpr size_t num_partitions = 16;
+
+// forum vid -> (forum id, number of posts), partitioned by forum vid
+using ForumCounts = tsl::hopscotch_map<int64_t, std::pair<int64_t, int32_t>>;
+using ForumPartitions = std::array<ForumCounts, num_partitions>;
+
+// Every worker task aggregates into its own partitions; reduction only collects the pointers.
+struct PartitionedCounts {
+    std::vector<std::shared_ptr<ForumPartitions>> tables;
+};
+
+void ProcessPersonPosts(lgraph_api::VertexIterator& person, PartitionedCounts& post_counts, const int64_t min_date) {
+    if (post_counts.tables.empty()) post_counts.tables.emplace_back(std::make_shared<ForumPartitions>());
+    auto& partitions = *post_counts.tables.front();
     for (auto person_forums = LabeledInEdgeIterator(person, HASMEMBER, min_date); person_forums.IsValid();
          person_forums.Next()) {
-        auto forum_id = person_forums[HASMEMBER_FORUMID].integer();
-        auto num_posts = person_forums[HASMEMBER_NUMPOSTS].integer();
-        if (num_posts == 0) {
-            auto &tail = post_counts.first;
-            if (tail.size() < 20/*limit*/ || *tail.rbegin() > forum_id) {
-                tail.emplace(forum_id);
-                if (tail.size() > 20) tail.erase(--tail.end());
-            }
+        int64_t forum_vid = person_forums.GetSrc();
+        int32_t num_posts = Edge<HASMEMBER>::Get<HASMEMBER_NUMPOSTS>(person_forums);
+        auto& counts = partitions[forum_vid % num_partitions];
+        auto it = counts.find(forum_vid);
+        if (it != counts.end()) {
+            it.value().second += num_posts;
         } else {
-            post_counts.second.emplace_back(forum_id, num_posts);
+            counts.emplace(forum_vid, std::make_pair(Edge<HASMEMBER>::Get<HASMEMBER_FORUMID>(person_forums), num_posts));
         }
     }
 }
 
 extern "C" bool Process(GraphDB& db, const std::string& request, std::string& response) {
     constexpr size_t limit_results = 20;
+    ArenaScope arena("interactive_complex_read_5");
     std::string input = lgraph_api::base64::Decode(request);
     std::stringstream iss(input);
     int64_t person_id = ReadInt64(iss);
@@ -45,14 +56,14 @@ extern "C" bool Process(GraphDB& db, const std::string& request, std::string& re
         auto iit = txn.GetVertexIndexIterator(PERSON, PERSON_ID, fd, fd);
         start_vid = iit.GetVid();
     }
-    tsl::hopscotch_set<int64_t> visited({start_vid});
-    std::vector<int64_t> curr_frontier({start_vid});
+    ArenaHashSet<int64_t> visited({start_vid});
+    ArenaVector<int64_t> curr_frontier({start_vid});
     auto person = txn.GetVertexIterator();
     size_t stat_num_0 = 0;
     size_t stat_num_1 = 0;
     std::vector<int64_t> friends;
     for (int hop = 0; hop <= 2; hop++) {
-        std::vector<int64_t> next_frontier;
+        ArenaVector<int64_t> next_frontier;
         for (auto vid : curr_frontier) {
             person.Goto(vid);
             if (hop < 2) {
@@ -79,73 +90,54 @@ extern "C" bool Process(GraphDB& db, const std::string& request, std::string& re
         std::sort(next_frontier.begin(), next_frontier.end());
         curr_frontier.swap(next_frontier);
     }
-    using result_type = std::pair<std::set<int64_t>, std::vector<std::tuple<int64_t, int32_t>>>;
     static std::vector<Worker> workers(worker_num);
-    auto post_counts = ForEachVertex<result_type>(
+    auto post_counts = ForEachVertex<PartitionedCounts>(
         db, txn, workers, friends,
-        [&](Transaction& t, VertexIterator& vit, result_type& local) {
+        [&](Transaction& t, VertexIterator& vit, PartitionedCounts& local) {
             ProcessPersonPosts(vit, local, min_date);
         },
-        [&](const result_type& local, result_type& res) {
-            res.first.insert(local.first.begin(), local.first.end());
-            res.second.insert(res.second.end(), local.second.begin(), local.second.end());
+        [&](const PartitionedCounts& local, PartitionedCounts& res) {
+            res.tables.insert(res.tables.end(), local.tables.begin(), local.tables.end());
         });
-    // select candidates
-    std::set<std::tuple<int32_t, int64_t>> candidates;
-    if (!post_counts.second.empty()) {
-        std::sort(post_counts.second.begin(), post_counts.second.end());
-        int64_t last_forum = std::get<0>(post_counts.second[0]);
-        int32_t post_count = std::get<1>(post_counts.second[0]);
-        for (size_t i = 1; i < post_counts.second.size(); i++) {
-            int64_t curr_forum = std::get<0>(post_counts.second[i]);
-            if (curr_forum == last_forum) {
-                post_count += std::get<1>(post_counts.second[i]);
-                continue;
-            }
-            int64_t forum_id = last_forum;
-            auto tup = std::make_tuple(0 - post_count, forum_id);
-            if (candidates.size() < limit_results || *candidates.rbegin() > tup) {
-                candidates.emplace(tup);
-                if (candidates.size() > limit_results){
-                    candidates.erase(--candidates.end());
+    // merge each partition across tasks and keep its local top-k; candidates are (-posts, forum id, forum vid). Counts
+    // are only final after the merge, when every forum is a candidate exactly once, so a partial_sort over the complete
+    // list does what TopK would without a heap.
+    using candidate_type = std::tuple<int32_t, int64_t, int64_t>;
+    std::vector<std::vector<candidate_type>> partition_candidates(num_partitions);
+    if (!post_counts.tables.empty()) {
+#pragma omp parallel for num_threads(worker_num)
+        for (size_t p = 0; p < num_partitions; p++) {
+            auto& merged = (*post_counts.tables.front())[p];
+            for (size_t i = 1; i < post_counts.tables.size(); i++) {
+                for (auto& kv : (*post_counts.tables[i])[p]) {
+                    auto it = merged.find(kv.first);
+                    if (it != merged.end()) {
+                        it.value().second += kv.second.second;
+                    } else {
+                        merged.emplace(kv.first, kv.second);
+                    }
                 }
             }
-            last_forum = curr_forum;
-            post_count = std::get<1>(post_counts.second[i]);
-        }
-        int64_t forum_id = last_forum;
-        auto tup = std::make_tuple(0 - post_count, forum_id);
-        if (candidates.size() < limit_results || *candidates.rbegin() > tup) {
-            candidates.emplace(tup);
-            if (candidates.size() > limit_results) {
-                candidates.erase(--candidates.end());
-            }
+            auto& candidates = partition_candidates[p];
+            for (auto& kv : merged) candidates.emplace_back(0 - kv.second.second, kv.second.first, kv.first);
+            size_t k = std::min(limit_results, candidates.size());
+            std::partial_sort(candidates.begin(), candidates.begin() + k, candidates.end());
+            candidates.resize(k);
         }
     }
+    std::vector<candidate_type> candidates;
+    for (auto& c : partition_candidates) candidates.insert(candidates.end(), c.begin(), c.end());
+    size_t res_size = std::min(limit_results, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + res_size, candidates.end());
 
     // output results
     std::stringstream oss;
-    int res_size = std::min(limit_results, candidates.size() + post_counts.first.size());
     WriteInt16(oss, res_size);
-    for (auto& tup : candidates) {
-        auto fit = txn.GetVertexByUniqueIndex(FORUM, FORUM_ID, lgraph_api::FieldData::Int64(std::get<1>(tup)));
-        WriteString(oss, fit[FORUM_TITLE].string());
-        WriteInt32(oss, 0 - std::get<0>(tup));
-    }
-    int res_count = candidates.size();
-    if (res_count != res_size){
-        tsl::hopscotch_set<int64_t> candidates_forum_ids;
-        for (auto tuple_item:candidates) {
-            candidates_forum_ids.emplace(std::get<1>(tuple_item));
-        }
-        for (auto it = post_counts.first.begin(); it != post_counts.first.end(); it++) {
-            if (res_count == res_size) break;
-            if (candidates_forum_ids.find(*it)!=candidates_forum_ids.end()) continue;
-            auto fit = txn.GetVertexByUniqueIndex(FORUM, FORUM_ID, lgraph_api::FieldData::Int64(*it));
-            WriteString(oss, fit[FORUM_TITLE].string());
-            WriteInt32(oss, 0);
-            res_count++;
-        }
+    auto forum = txn.GetVertexIterator();
+    for (size_t i = 0; i < res_size; i++) {
+        forum.Goto(std::get<2>(candidates[i]));
+        WriteStringField(oss, forum, FORUM_TITLE);
+        WriteInt32(oss, 0 - std::get<0>(candidates[i]));
     }
     response = oss.str();
     return true;
@@ -1,64 +1,14 @@
-#include <map>
-#include <tuple>
+#include <algorithm>
+#include <iterator>
+#include <vector>
 
 #include "lgraph/lgraph.h"
 #include "snb_common.h"
 #include "snb_constants.h"
-#include "tsl/hopscotch_map.h"
-#include "tsl/hopscotch_set.h"
-
-inline int64_t FetchPersonId(int64_t person_vid, lgraph_api::VertexIterator& person,
-                             tsl::hopscotch_map<int64_t, int64_t>& person_id_map) {
-    auto it = person_id_map.find(person_vid);
-    if (it != person_id_map.end()) return it->second;
-    person.Goto(person_vid);
-    int64_t person_id = person[PERSON_ID].integer();
-    person_id_map[person_vid] = person_id;
-    return person_id;
-}
-
-void ProcessMessageLikes(
-    lgraph_api::VertexIterator& message, int64_t message_id, int64_t message_creation_date,
-    const std::string& message_content, lgraph_api::VertexIterator& person,
-    tsl::hopscotch_map<int64_t, int64_t>& person_id_map,
-    tsl::hopscotch_map<int64_t, std::pair<int64_t, int64_t> >& candidates_index,
-    std::map<std::pair<int64_t, int64_t>, std::tuple<int64_t, int64_t, std::string, int32_t> >& candidates,
-    const size_t limit_results) {
-    for (auto message_likes = lgraph_api::LabeledInEdgeIterator(message, LIKES); message_likes.IsValid();
-         message_likes.Next()) {
-        int64_t like_creation_date = message_likes[LIKES_CREATIONDATE].integer();
-        int64_t person_vid = message_likes.GetSrc();
-        auto it = candidates_index.find(person_vid);
-        if (it != candidates_index.end()) {
-            auto& key = it.value();
-            if (like_creation_date < 0 - key.first) continue;
-            if (like_creation_date == 0 - key.first) {
-                auto cit = candidates.find(key);
-                int64_t old_message_id = std::get<1>(cit->second);
-                if (message_id > old_message_id) continue;
-            }
-            candidates.erase(key);
-            key.first = 0 - like_creation_date;
-            candidates.emplace(key, std::make_tuple(person_vid, message_id, message_content,
-                                                    (like_creation_date - message_creation_date) / 1000 / 60));
-        } else {
-            int64_t person_id = FetchPersonId(person_vid, person, person_id_map);
-            auto key = std::make_pair(0 - like_creation_date, person_id);
-            if (candidates.size() >= limit_results && candidates.lower_bound(key) == candidates.end()) continue;
-            candidates.emplace(key, std::make_tuple(person_vid, message_id, message_content,
-                                                    (like_creation_date - message_creation_date) / 1000 / 60));
-            candidates_index.emplace(person_vid, key);
-            if (candidates.size() > limit_results) {
-                auto it = --candidates.end();
-                candidates_index.erase(candidates_index.find(std::get<0>(it->second)));
-                candidates.erase(it);
-            }
-        }
-    }
-}
 
 extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std::string& response) {
     constexpr size_t limit_results = 20;
+    static_assert(RECENT_LIKERS_LIMIT >= limit_results, "Person.recentLikers is too short");
 
     std::string input = lgraph_api::base64::Decode(request);
     std::stringstream iss(input);
@@ -67,73 +17,55 @@ extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std
     auto txn = db.CreateReadTxn();
     std::stringstream oss;
 
-    tsl::hopscotch_set<int64_t> friends;
-    tsl::hopscotch_map<int64_t, int64_t> person_id_map;
     auto person = txn.GetVertexByUniqueIndex(PERSON, PERSON_ID, lgraph_api::FieldData::Int64(person_id));
-    auto person_friend = txn.GetVertexIterator();
+    auto recent_likers = UnpackRecords<RecentLike>(person[PERSON_RECENTLIKERS]);
+    if (recent_likers.size() > limit_results) recent_likers.resize(limit_results);
+
+    // knows adjacencies are sorted by the other endpoint, so friends among the likers come from sorted intersections
+    std::vector<int64_t> liker_vids;
+    for (auto& like : recent_likers) liker_vids.emplace_back(like.liker_vid);
+    std::sort(liker_vids.begin(), liker_vids.end());
+    std::vector<int64_t> out_friends, in_friends, friend_likers;
     for (auto person_friends = lgraph_api::LabeledOutEdgeIterator(person, KNOWS); person_friends.IsValid();
          person_friends.Next()) {
-        int64_t friend_vid = person_friends.GetDst();
-        friends.emplace(friend_vid);
-        person_friend.Goto(friend_vid);
-        person_id_map[friend_vid] = person_friend[PERSON_ID].integer();
+        out_friends.emplace_back(person_friends.GetDst());
     }
     for (auto person_friends = lgraph_api::LabeledInEdgeIterator(person, KNOWS); person_friends.IsValid();
          person_friends.Next()) {
-        int64_t friend_vid = person_friends.GetSrc();
-        friends.emplace(friend_vid);
-        person_friend.Goto(friend_vid);
-        person_id_map[friend_vid] = person_friend[PERSON_ID].integer();
+        in_friends.emplace_back(person_friends.GetSrc());
     }
+    std::set_intersection(liker_vids.begin(), liker_vids.end(), out_friends.begin(), out_friends.end(),
+                          std::back_inserter(friend_likers));
+    std::set_intersection(liker_vids.begin(), liker_vids.end(), in_friends.begin(), in_friends.end(),
+                          std::back_inserter(friend_likers));
+    std::sort(friend_likers.begin(), friend_likers.end());
 
-    tsl::hopscotch_map<int64_t, std::pair<int64_t, int64_t> > candidates_index;
-    std::map<std::pair<int64_t, int64_t>, std::tuple<int64_t, int64_t, std::string, int32_t> > candidates;
-    auto message = txn.GetVertexIterator();
+    WriteInt16(oss, recent_likers.size());
     auto liker = txn.GetVertexIterator();
-    for (auto person_posts = lgraph_api::LabeledInEdgeIterator(person, POSTHASCREATOR); person_posts.IsValid();
-         person_posts.Next()) {
-        int64_t message_vid = person_posts.GetSrc();
-        message.Goto(message_vid);
-        int64_t message_id;
+    auto message = txn.GetVertexIterator();
+    for (auto& like : recent_likers) {
+        WriteInt64(oss, like.liker_id);
+        liker.Goto(like.liker_vid);
+        WriteStringField(oss, liker, PERSON_FIRSTNAME);
+        WriteStringField(oss, liker, PERSON_LASTNAME);
+        WriteInt64(oss, like.creation_date);
+        WriteInt64(oss, like.message_id);
+        message.Goto(like.message_vid);
         int64_t message_creation_date;
-        std::string message_content;
-        message_id = message[POST_ID].integer();
-        message_creation_date = message[POST_CREATIONDATE].integer();
-        auto fd = message[POST_CONTENT];
-        if (!fd.is_null()) {
-            message_content = fd.string();
-        } else {
-            message_content = message[POST_IMAGEFILE].string();
+        if (message.GetLabelId() == POST) {
+            message_creation_date = Vertex<POST>::Get<POST_CREATIONDATE>(message);
+            auto fd = message[POST_CONTENT];
+            if (!fd.is_null()) {
+                WriteString(oss, fd.string());
+            } else {
+                WriteStringField(oss, message, POST_IMAGEFILE);
+            }
+        } else /* COMMENT */ {
+            message_creation_date = Vertex<COMMENT>::Get<COMMENT_CREATIONDATE>(message);
+            WriteStringField(oss, message, COMMENT_CONTENT);
         }
-        ProcessMessageLikes(message, message_id, message_creation_date, message_content, liker, person_id_map,
-                            candidates_index, candidates, limit_results);
-    }
-    for (auto person_comments = lgraph_api::LabeledInEdgeIterator(person, COMMENTHASCREATOR); person_comments.IsValid();
-         person_comments.Next()) {
-        int64_t message_vid = person_comments.GetSrc();
-        message.Goto(message_vid);
-        int64_t message_id;
-        int64_t message_creation_date;
-        std::string message_content;
-        message_id = message[COMMENT_ID].integer();
-        message_creation_date = message[COMMENT_CREATIONDATE].integer();
-        message_content = message[COMMENT_CONTENT].string();
-        ProcessMessageLikes(message, message_id, message_creation_date, message_content, liker, person_id_map,
-                            candidates_index, candidates, limit_results);
-    }
-
-    WriteInt16(oss, candidates.size());
-    for (auto it = candidates.begin(); it != candidates.end(); it++) {
-        WriteInt64(oss, it->first.second);
-        int64_t person_vid = std::get<0>(it->second);
-        person.Goto(person_vid);
-        WriteString(oss, person[PERSON_FIRSTNAME].string());
-        WriteString(oss, person[PERSON_LASTNAME].string());
-        WriteInt64(oss, 0 - it->first.first);
-        WriteInt64(oss, std::get<1>(it->second));
-        WriteString(oss, std::get<2>(it->second));
-        WriteInt32(oss, std::get<3>(it->second));
-        WriteBool(oss, friends.find(person_vid) == friends.end());
+        WriteInt32(oss, (like.creation_date - message_creation_date) / 1000 / 60);
+        WriteBool(oss, !std::binary_search(friend_likers.begin(), friend_likers.end(), like.liker_vid));
     }
 
     response = oss.str();
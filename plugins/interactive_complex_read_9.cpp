@@ -1,71 +1,42 @@
-#include <set>
 #include <tuple>
 
 #include "lgraph/lgraph.h"
 #include "snb_common.h"
 #include "snb_constants.h"
-#include "tsl/hopscotch_set.h"
+
+constexpr size_t limit_results = 20;
+
+// (-creationDate, message id, friend vid, message vid)
+using Candidates = TopK<std::tuple<int64_t, int64_t, int64_t, int64_t>, limit_results>;
 
 void ProcessFriendMessages(lgraph_api::VertexIterator& person_friend, lgraph_api::VertexIterator& message,
-                           std::set<std::tuple<int64_t, int64_t, int64_t, int64_t> >& candidates,
-                           const int64_t max_date, const size_t limit_results) {
+                           Candidates& candidates, const int64_t max_date) {
     for (auto friend_posts = lgraph_api::LabeledInEdgeIterator(person_friend, POSTHASCREATOR); friend_posts.IsValid();
          friend_posts.Next()) {
-        int64_t creation_date = friend_posts[POSTHASCREATOR_CREATIONDATE].integer();
+        int64_t creation_date = Edge<POSTHASCREATOR>::Get<POSTHASCREATOR_CREATIONDATE>(friend_posts);
         if (creation_date > max_date) continue;
-        int64_t message_vid = -1;
-        int64_t message_id;
-        if (candidates.size() >= limit_results) {
-            auto& candidate = *candidates.rbegin();
-            if (0 - creation_date > std::get<0>(candidate)) continue;
-            if (0 - creation_date == std::get<0>(candidate)) {
-                message_vid = friend_posts.GetSrc();
-                message.Goto(message_vid);
-                message_id = message[POST_ID].integer();
-                if (message_id > std::get<1>(candidate)) continue;
-            }
-        }
-        if (message_vid == -1) {
-            message_vid = friend_posts.GetSrc();
+        candidates.Offer(0 - creation_date, [&]() {
+            int64_t message_vid = friend_posts.GetSrc();
             message.Goto(message_vid);
-            message_id = message[POST_ID].integer();
-        }
-        candidates.emplace(0 - creation_date, message_id, person_friend.GetId(), message_vid);
-        if (candidates.size() > limit_results) {
-            candidates.erase(--candidates.end());
-        }
+            return std::make_tuple(0 - creation_date, Vertex<POST>::Get<POST_ID>(message), person_friend.GetId(),
+                                   message_vid);
+        });
     }
     for (auto friend_comments = lgraph_api::LabeledInEdgeIterator(person_friend, COMMENTHASCREATOR);
          friend_comments.IsValid(); friend_comments.Next()) {
-        int64_t creation_date = friend_comments[COMMENTHASCREATOR_CREATIONDATE].integer();
+        int64_t creation_date = Edge<COMMENTHASCREATOR>::Get<COMMENTHASCREATOR_CREATIONDATE>(friend_comments);
         if (creation_date > max_date) continue;
-        int64_t message_vid = -1;
-        int64_t message_id;
-        if (candidates.size() >= limit_results) {
-            auto& candidate = *candidates.rbegin();
-            if (0 - creation_date > std::get<0>(candidate)) continue;
-            if (0 - creation_date == std::get<0>(candidate)) {
-                message_vid = friend_comments.GetSrc();
-                message.Goto(message_vid);
-                message_id = message[COMMENT_ID].integer();
-                if (message_id > std::get<1>(candidate)) continue;
-            }
-        }
-        if (message_vid == -1) {
-            message_vid = friend_comments.GetSrc();
+        candidates.Offer(0 - creation_date, [&]() {
+            int64_t message_vid = friend_comments.GetSrc();
             message.Goto(message_vid);
-            message_id = message[COMMENT_ID].integer();
-        }
-        candidates.emplace(0 - creation_date, message_id, person_friend.GetId(), 0 - message_vid);
-        if (candidates.size() > limit_results) {
-            candidates.erase(--candidates.end());
-        }
+            return std::make_tuple(0 - creation_date, Vertex<COMMENT>::Get<COMMENT_ID>(message), person_friend.GetId(),
+                                   message_vid);
+        });
     }
 }
 
 extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std::string& response) {
-    constexpr size_t limit_results = 20;
-
+    ArenaScope arena("interactive_complex_read_9");
     std::string input = lgraph_api::base64::Decode(request);
     std::stringstream iss(input);
     int64_t person_id = ReadInt64(iss);
@@ -79,12 +50,12 @@ extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std
         start_vid = iit.GetVid();
     }
     auto message = txn.GetVertexIterator();
-    std::set<std::tuple<int64_t, int64_t, int64_t, int64_t> > candidates;
-    tsl::hopscotch_set<int64_t> visited({start_vid});
-    std::vector<int64_t> curr_frontier({start_vid});
+    Candidates candidates;
+    ArenaHashSet<int64_t> visited({start_vid});
+    ArenaVector<int64_t> curr_frontier({start_vid});
     auto person = txn.GetVertexIterator();
     for (int hop = 0; hop <= 2; hop++) {
-        std::vector<int64_t> next_frontier;
+        ArenaVector<int64_t> next_frontier;
         for (auto vid : curr_frontier) {
             person.Goto(vid);
             if (hop < 2) {
@@ -106,26 +77,25 @@ extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std
                 }
             }
             if (hop == 0) continue;
-            ProcessFriendMessages(person, message, candidates, max_date, limit_results);
+            ProcessFriendMessages(person, message, candidates, max_date);
         }
         std::sort(next_frontier.begin(), next_frontier.end());
         curr_frontier.swap(next_frontier);
     }
     std::stringstream oss;
     WriteInt16(oss, candidates.size());
-    for (auto& tup : candidates) {
+    for (auto& tup : candidates.Sorted()) {
         person.Goto(std::get<2>(tup));
-        WriteInt64(oss, person[PERSON_ID].integer());
-        WriteString(oss, person[PERSON_FIRSTNAME].string());
-        WriteString(oss, person[PERSON_LASTNAME].string());
+        WriteInt64(oss, Vertex<PERSON>::Get<PERSON_ID>(person));
+        WriteStringField(oss, person, PERSON_FIRSTNAME);
+        WriteStringField(oss, person, PERSON_LASTNAME);
         WriteInt64(oss, std::get<1>(tup));
-        if (std::get<3>(tup) >= 0) {
-            message.Goto(std::get<3>(tup));
+        message.Goto(std::get<3>(tup));
+        if (message.GetLabelId() == POST) {
             auto content = message[POST_CONTENT];
-            WriteString(oss, content.is_null() ? message[POST_IMAGEFILE].string() : content.string());
-        } else {
-            message.Goto(-std::get<3>(tup));
-            WriteString(oss, message[COMMENT_CONTENT].string());
+            WriteString(oss, content.is_null() ? Vertex<POST>::GetRequired<POST_IMAGEFILE>(message) : content.string());
+        } else /* COMMENT */ {
+            WriteStringField(oss, message, COMMENT_CONTENT);
         }
         WriteInt64(oss, 0 - std::get<0>(tup));
     }
@@ -2,25 +2,24 @@
 #include "snb_common.h"
 #include "snb_constants.h"
 
-extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std::string& response) {
-    std::string input = lgraph_api::base64::Decode(request);
-    std::stringstream iss(input);
+void InteractiveShortRead1(lgraph_api::GraphDB& db, lgraph_api::Transaction& txn, std::stringstream& iss,
+                           std::stringstream& oss) {
     int64_t person_id = ReadInt64(iss);
 
-    auto txn = db.CreateReadTxn();
-    std::stringstream oss;
-
     auto person = txn.GetVertexByUniqueIndex(PERSON, PERSON_ID, lgraph_api::FieldData::Int64(person_id));
-    WriteString(oss, person[PERSON_FIRSTNAME].string());
-    WriteString(oss, person[PERSON_LASTNAME].string());
-    WriteInt64(oss, person[PERSON_BIRTHDAY].integer());
-    WriteString(oss, person[PERSON_LOCATIONIP].string());
-    WriteString(oss, person[PERSON_BROWSERUSED].string());
-    auto place = txn.GetVertexIterator(person[PERSON_PLACE].integer());
-    WriteInt64(oss, place[PLACE_ID].integer());
-    WriteString(oss, person[PERSON_GENDER].string());
-    WriteInt64(oss, person[PERSON_CREATIONDATE].integer());
+    WriteStringField(oss, person, PERSON_FIRSTNAME);
+    WriteStringField(oss, person, PERSON_LASTNAME);
+    WriteInt64(oss, Vertex<PERSON>::Get<PERSON_BIRTHDAY>(person));
+    WriteStringField(oss, person, PERSON_LOCATIONIP);
+    WriteStringField(oss, person, PERSON_BROWSERUSED);
+    auto place = txn.GetVertexIterator(Vertex<PERSON>::Get<PERSON_PLACE>(person));
+    WriteInt64(oss, Vertex<PLACE>::Get<PLACE_ID>(place));
+    WriteStringField(oss, person, PERSON_GENDER);
+    WriteInt64(oss, Vertex<PERSON>::Get<PERSON_CREATIONDATE>(person));
+}
 
-    response = oss.str();
-    return true;
+#ifndef INTERACTIVE_BATCH
+extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std::string& response) {
+    return ProcessShortRead(db, "interactive_short_read_1", request, response, InteractiveShortRead1);
 }
+#endif
@@ -1,83 +1,97 @@
-#include <set>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <vector>
 
 #include "lgraph/lgraph.h"
 #include "snb_common.h"
 #include "snb_constants.h"
 
-extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std::string& response) {
+void InteractiveShortRead2(lgraph_api::GraphDB& db, lgraph_api::Transaction& txn, std::stringstream& iss,
+                           std::stringstream& oss) {
     constexpr size_t limit_messages = 10;
 
-    std::string input = lgraph_api::base64::Decode(request);
-    std::stringstream iss(input);
     int64_t person_id = ReadInt64(iss);
 
-    auto txn = db.CreateReadTxn();
-    std::stringstream oss;
-
     // TODO: check whether there are cases when creationDates are the same while messageIds are different
     auto person = txn.GetVertexByUniqueIndex(PERSON, PERSON_ID, lgraph_api::FieldData::Int64(person_id));
-    std::set<std::pair<int64_t, int64_t> > candidates;
+    DependOn(person.GetId());
+    // (creationDate, message vid, is comment), latest first
+    using Candidate = std::tuple<int64_t, int64_t, bool>;
+    TopK<Candidate, limit_messages, std::greater<Candidate> > candidates;
     for (auto person_posts = lgraph_api::LabeledInEdgeIterator(person, POSTHASCREATOR); person_posts.IsValid();
          person_posts.Next()) {
-        int64_t creation_date = person_posts[POSTHASCREATOR_CREATIONDATE].integer();
-        if (candidates.size() < limit_messages || creation_date > candidates.begin()->first) {
-            candidates.emplace(creation_date, person_posts.GetSrc());
-            if (candidates.size() > limit_messages) {
-                candidates.erase(candidates.begin());
-            }
-        }
+        int64_t creation_date = Edge<POSTHASCREATOR>::Get<POSTHASCREATOR_CREATIONDATE>(person_posts);
+        candidates.Offer(std::make_tuple(creation_date, person_posts.GetSrc(), false));
     }
     for (auto person_comments = lgraph_api::LabeledInEdgeIterator(person, COMMENTHASCREATOR); person_comments.IsValid();
          person_comments.Next()) {
-        int64_t creation_date = person_comments[POSTHASCREATOR_CREATIONDATE].integer();
-        if (candidates.size() < limit_messages || creation_date > candidates.begin()->first) {
-            candidates.emplace(creation_date, person_comments.GetSrc());
-            if (candidates.size() > limit_messages) {
-                candidates.erase(candidates.begin());
-            }
-        }
+        int64_t creation_date = Edge<COMMENTHASCREATOR>::Get<COMMENTHASCREATOR_CREATIONDATE>(person_comments);
+        candidates.Offer(std::make_tuple(creation_date, person_comments.GetSrc(), true));
     }
-    WriteInt16(oss, candidates.size());
-    for (auto it = candidates.rbegin(); it != candidates.rend(); it++) {
-        auto message = txn.GetVertexIterator(it->second);
-        if (message.GetLabelId() == COMMENT) {
-            int64_t message_id = message[COMMENT_ID].integer();
-            WriteInt64(oss, message_id);
-            WriteString(oss, message[COMMENT_CONTENT].string());
-            WriteInt64(oss, it->first);
-            while (true) {
-                auto reply_of_comment = message[COMMENT_REPLYOFCOMMENT];
-                if (!reply_of_comment.is_null()) {
-                    message.Goto(reply_of_comment.integer());
-                } else {
-                    message.Goto(message[COMMENT_REPLYOFPOST].integer());
-                    break;
-                }
-            }
-            message_id = message[POST_ID].integer();
-            WriteInt64(oss, message_id);
-            auto author = txn.GetVertexIterator(message[POST_CREATOR].integer());
-            WriteInt64(oss, author[PERSON_ID].integer());
-            WriteString(oss, author[PERSON_FIRSTNAME].string());
-            WriteString(oss, author[PERSON_LASTNAME].string());
-        } else /* POST */ {
-            int64_t message_id = message[POST_ID].integer();
-            WriteInt64(oss, message_id);
-            auto content = message[POST_CONTENT];
-            if (!content.is_null()) {
-                WriteString(oss, content.string());
-            } else {
-                WriteString(oss, message[POST_IMAGEFILE].string());
-            }
-            WriteInt64(oss, it->first);
-            WriteInt64(oss, message_id);
-            auto author = txn.GetVertexIterator(message[POST_CREATOR].integer());
-            WriteInt64(oss, author[PERSON_ID].integer());
-            WriteString(oss, author[PERSON_FIRSTNAME].string());
-            WriteString(oss, author[PERSON_LASTNAME].string());
+    auto messages = candidates.Sorted();
+    size_t num_messages = messages.size();
+    // The chains message -> root post -> author are independent, so they advance in lock step: each hop reads the
+    // vertices of all chains in one sorted batch instead of following every chain to its end before the next one
+    // (see FetchVertices for why this is not a coroutine scheduler).
+    std::vector<int64_t> message_ids(num_messages), root_ids(num_messages), author_vids(num_messages);
+    std::vector<std::string> contents(num_messages);
+    std::vector<int64_t> post_vids, comment_vids;
+    std::vector<size_t> post_slots, comment_slots;
+    for (size_t slot = 0; slot < num_messages; slot++) {
+        int64_t message_vid = std::get<1>(messages[slot]);
+        if (std::get<2>(messages[slot])) {
+            comment_vids.emplace_back(message_vid);
+            comment_slots.emplace_back(slot);
+        } else {
+            post_vids.emplace_back(message_vid);
+            post_slots.emplace_back(slot);
         }
     }
+    FetchVertices(txn, post_vids, {POST_ID, POST_CONTENT, POST_IMAGEFILE},
+                  [&](size_t i, const std::vector<lgraph_api::FieldData>& values) {
+                      size_t slot = post_slots[i];
+                      message_ids[slot] = root_ids[slot] = VertexField<POST, POST_ID>::Get(values[0]);
+                      contents[slot] = values[1].is_null() ? VertexField<POST, POST_IMAGEFILE>::Get(values[2])
+                                                           : VertexField<POST, POST_CONTENT>::Get(values[1]);
+                      author_vids[slot] = person.GetId();
+                  });
+    std::vector<int64_t> root_vids(comment_vids.size());
+    FetchVertices(txn, comment_vids, {COMMENT_ID, COMMENT_CONTENT, COMMENT_ROOTPOST},
+                  [&](size_t i, const std::vector<lgraph_api::FieldData>& values) {
+                      size_t slot = comment_slots[i];
+                      message_ids[slot] = VertexField<COMMENT, COMMENT_ID>::Get(values[0]);
+                      contents[slot] = VertexField<COMMENT, COMMENT_CONTENT>::Get(values[1]);
+                      root_vids[i] = VertexField<COMMENT, COMMENT_ROOTPOST>::Get(values[2]);
+                  });
+    FetchVertices(txn, root_vids, {POST_ID, POST_CREATOR},
+                  [&](size_t i, const std::vector<lgraph_api::FieldData>& values) {
+                      size_t slot = comment_slots[i];
+                      root_ids[slot] = VertexField<POST, POST_ID>::Get(values[0]);
+                      author_vids[slot] = VertexField<POST, POST_CREATOR>::Get(values[1]);
+                  });
+    std::vector<int64_t> author_ids(num_messages);
+    std::vector<std::string> author_first_names(num_messages), author_last_names(num_messages);
+    FetchVertices(txn, author_vids, {PERSON_ID, PERSON_FIRSTNAME, PERSON_LASTNAME},
+                  [&](size_t slot, const std::vector<lgraph_api::FieldData>& values) {
+                      author_ids[slot] = VertexField<PERSON, PERSON_ID>::Get(values[0]);
+                      author_first_names[slot] = VertexField<PERSON, PERSON_FIRSTNAME>::Get(values[1]);
+                      author_last_names[slot] = VertexField<PERSON, PERSON_LASTNAME>::Get(values[2]);
+                  });
+    WriteInt16(oss, num_messages);
+    for (size_t slot = 0; slot < num_messages; slot++) {
+        WriteInt64(oss, message_ids[slot]);
+        WriteString(oss, contents[slot]);
+        WriteInt64(oss, std::get<0>(messages[slot]));
+        WriteInt64(oss, root_ids[slot]);
+        WriteInt64(oss, author_ids[slot]);
+        WriteString(oss, author_first_names[slot]);
+        WriteString(oss, author_last_names[slot]);
+    }
+}
 
-    response = oss.str();
-    return true;
+#ifndef INTERACTIVE_BATCH
+extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std::string& response) {
+    return ProcessShortRead(db, "interactive_short_read_2", request, response, InteractiveShortRead2);
 }
+#endif
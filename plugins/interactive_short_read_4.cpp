@@ -2,31 +2,30 @@
 #include "snb_common.h"
 #include "snb_constants.h"
 
-extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std::string& response) {
-    std::string input = lgraph_api::base64::Decode(request);
-    std::stringstream iss(input);
+void InteractiveShortRead4(lgraph_api::GraphDB& db, lgraph_api::Transaction& txn, std::stringstream& iss,
+                           std::stringstream& oss) {
     int64_t message_id = ReadInt64(iss);
 
-    auto txn = db.CreateReadTxn();
-    std::stringstream oss;
-
     auto fd = lgraph_api::FieldData::Int64(message_id);
     auto iit = txn.GetVertexIndexIterator(COMMENT, COMMENT_ID, fd, fd);
     if (iit.IsValid()) {
         auto comment = txn.GetVertexIterator(iit.GetVid());
-        WriteInt64(oss, comment[COMMENT_CREATIONDATE].integer());
-        WriteString(oss, comment[COMMENT_CONTENT].string());
+        WriteInt64(oss, Vertex<COMMENT>::Get<COMMENT_CREATIONDATE>(comment));
+        WriteStringField(oss, comment, COMMENT_CONTENT);
     } else {
         auto post = txn.GetVertexByUniqueIndex(POST, POST_ID, fd);
-        WriteInt64(oss, post[POST_CREATIONDATE].integer());
+        WriteInt64(oss, Vertex<POST>::Get<POST_CREATIONDATE>(post));
         auto content = post[POST_CONTENT];
         if (!content.is_null()) {
             WriteString(oss, content.string());
         } else {
-            WriteString(oss, post[POST_IMAGEFILE].string());
+            WriteStringField(oss, post, POST_IMAGEFILE);
         }
     }
+}
 
-    response = oss.str();
-    return true;
+#ifndef INTERACTIVE_BATCH
+extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std::string& response) {
+    return ProcessShortRead(db, "interactive_short_read_4", request, response, InteractiveShortRead4);
 }
+#endif
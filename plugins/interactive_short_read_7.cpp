@@ -7,14 +7,10 @@
 #include "snb_constants.h"
 #include "tsl/hopscotch_set.h"
 
-extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std::string& response) {
-    std::string input = lgraph_api::base64::Decode(request);
-    std::stringstream iss(input);
+void InteractiveShortRead7(lgraph_api::GraphDB& db, lgraph_api::Transaction& txn, std::stringstream& iss,
+                           std::stringstream& oss) {
     int64_t message_id = ReadInt64(iss);
 
-    auto txn = db.CreateReadTxn();
-    std::stringstream oss;
-
     auto fd = lgraph_api::FieldData::Int64(message_id);
     auto iit = txn.GetVertexIndexIterator(COMMENT, COMMENT_ID, fd, fd);
     bool message_is_post;
@@ -28,8 +24,10 @@ extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std
         message_vid = iit.GetVid();
     }
     auto message = txn.GetVertexIterator(message_vid);
-    auto message_creator = !message_is_post ? txn.GetVertexIterator(message[COMMENT_CREATOR].integer())
-                                            : txn.GetVertexIterator(message[POST_CREATOR].integer());
+    auto message_creator = !message_is_post ? txn.GetVertexIterator(Vertex<COMMENT>::Get<COMMENT_CREATOR>(message))
+                                            : txn.GetVertexIterator(Vertex<POST>::Get<POST_CREATOR>(message));
+    DependOn(message_vid);
+    DependOn(message_creator.GetId());
     tsl::hopscotch_set<int64_t> message_creator_friends;
     for (auto person_friends = lgraph_api::LabeledOutEdgeIterator(message_creator, KNOWS); person_friends.IsValid();
          person_friends.Next()) {
@@ -39,17 +37,30 @@ extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std
          person_friends.Next()) {
         message_creator_friends.emplace(person_friends.GetSrc());
     }
-    std::vector<std::tuple<int64_t, int64_t, int64_t, std::string, std::string, std::string, bool> > comments;
+    std::vector<int64_t> reply_vids;
     for (auto replies = lgraph_api::LabeledInEdgeIterator(message, REPLYOF); replies.IsValid(); replies.Next()) {
-        auto comment = txn.GetVertexIterator(replies.GetSrc());
-        int64_t comment_author_vid = comment[COMMENT_CREATOR].integer();
-        auto comment_author = txn.GetVertexIterator(comment_author_vid);
-        bool knows = message_creator_friends.find(comment_author_vid) != message_creator_friends.end();
-        comments.emplace_back(0 - comment[COMMENT_CREATIONDATE].integer(), comment_author[PERSON_ID].integer(),
-                              comment[COMMENT_ID].integer(), comment[COMMENT_CONTENT].string(),
-                              comment_author[PERSON_FIRSTNAME].string(), comment_author[PERSON_LASTNAME].string(),
-                              knows);
+        reply_vids.emplace_back(replies.GetSrc());
     }
+    // (-creation date, author id, comment id, content, author first name, author last name, author knows creator)
+    std::vector<std::tuple<int64_t, int64_t, int64_t, std::string, std::string, std::string, bool> > comments(
+        reply_vids.size());
+    std::vector<int64_t> author_vids(reply_vids.size());
+    FetchVertices(txn, reply_vids, {COMMENT_CREATIONDATE, COMMENT_CREATOR, COMMENT_ID, COMMENT_CONTENT},
+                  [&](size_t i, const std::vector<lgraph_api::FieldData>& values) {
+                      auto& comment = comments[i];
+                      author_vids[i] = VertexField<COMMENT, COMMENT_CREATOR>::Get(values[1]);
+                      std::get<0>(comment) = 0 - VertexField<COMMENT, COMMENT_CREATIONDATE>::Get(values[0]);
+                      std::get<2>(comment) = VertexField<COMMENT, COMMENT_ID>::Get(values[2]);
+                      std::get<3>(comment) = VertexField<COMMENT, COMMENT_CONTENT>::Get(values[3]);
+                      std::get<6>(comment) = message_creator_friends.count(author_vids[i]) != 0;
+                  });
+    FetchVertices(txn, author_vids, {PERSON_ID, PERSON_FIRSTNAME, PERSON_LASTNAME},
+                  [&](size_t i, const std::vector<lgraph_api::FieldData>& values) {
+                      auto& comment = comments[i];
+                      std::get<1>(comment) = VertexField<PERSON, PERSON_ID>::Get(values[0]);
+                      std::get<4>(comment) = VertexField<PERSON, PERSON_FIRSTNAME>::Get(values[1]);
+                      std::get<5>(comment) = VertexField<PERSON, PERSON_LASTNAME>::Get(values[2]);
+                  });
     std::sort(comments.begin(), comments.end());
     WriteInt16(oss, comments.size());
     for (auto& tup : comments) {
@@ -61,7 +72,10 @@ extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std
         WriteString(oss, std::get<5>(tup));
         WriteBool(oss, std::get<6>(tup));
     }
+}
 
-    response = oss.str();
-    return true;
+#ifndef INTERACTIVE_BATCH
+extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std::string& response) {
+    return ProcessShortRead(db, "interactive_short_read_7", request, response, InteractiveShortRead7);
 }
+#endif
@@ -2,51 +2,37 @@
 #include "snb_common.h"
 #include "snb_constants.h"
 
+bool InteractiveUpdate2(lgraph_api::GraphDB& db, std::stringstream& iss) {
+    int64_t person_id = ReadInt64(iss);
+    int64_t post_id = ReadInt64(iss);
+    int64_t creation_date = ReadInt64(iss);
+    bool committed = ExecuteUpdate(db, "interactive_update_2", [&](lgraph_api::Transaction& txn) {
+        int64_t person_vid = ResolveVid(txn, PERSON, person_id);
+        int64_t post_vid = ResolveVid(txn, POST, post_id);
+        txn.AddEdge(person_vid, post_vid, LIKES, {LIKES_CREATIONDATE},
+                    {lgraph_api::FieldData::Int64(creation_date)});
+        auto post = txn.GetVertexIterator(post_vid);
+        Vertex<POST>::Increment<POST_LIKECOUNT>(post, 1);
+        auto creator = txn.GetVertexIterator(post[POST_CREATOR].integer());
+        auto recent_likers = UnpackRecords<RecentLike>(creator[PERSON_RECENTLIKERS]);
+        if (OfferRecentLike(recent_likers, RecentLike{creation_date, person_id, person_vid, post_id, post_vid})) {
+            creator.SetField(PERSON_RECENTLIKERS, PackRecords(recent_likers));
+        }
+        NotifyWrite(person_vid);
+        NotifyWrite(post_vid);
+        NotifyWrite(creator.GetId());
+    });
+    return committed;
+}
+
+#ifndef INTERACTIVE_APPLY_UPDATES
 extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std::string& response) {
     std::stringstream oss;
     try {
-        auto txn = db.CreateReadTxn();
         std::string input = lgraph_api::base64::Decode(request);
         std::stringstream iss(input);
-        int64_t person_id = ReadInt64(iss);
-        int64_t person_vid;
-        {
-            auto fd = lgraph_api::FieldData::Int64(person_id);
-            auto iit = txn.GetVertexIndexIterator(PERSON, PERSON_ID, fd, fd);
-            person_vid = iit.GetVid();
-        }
-        int64_t post_id = ReadInt64(iss);
-        int64_t post_vid;
-        {
-            auto fd = lgraph_api::FieldData::Int64(post_id);
-            auto iit = txn.GetVertexIndexIterator(POST, POST_ID, fd, fd);
-            post_vid = iit.GetVid();
-        }
-        int64_t creation_date = ReadInt64(iss);
-        bool committed = false;
-        size_t num_attempts = 0;
-        while (num_attempts < 3) {
-            num_attempts++;
-            try {
-                txn.Abort();
-                txn = db.CreateWriteTxn(num_attempts > 2 ? false : true);
-                txn.AddEdge(person_vid, post_vid, LIKES, {LIKES_CREATIONDATE},
-                            {lgraph_api::FieldData::Int64(creation_date)});
-                txn.Commit();
-                committed = true;
-                break;
-            } catch (std::exception& e) {
-                std::string s(e.what());
-                if (s.find("CONFLICTS") == std::string::npos)
-                    std::cout << "interactive_update_2 exception: " << e.what() << std::endl;
-            }
-        }
-        if (committed) {
-            WriteInt16(oss, 0);
-        } else {
-            std::cout << "interactive_update_2 failed" << std::endl;
-            WriteInt16(oss, 1);
-        }
+        bool committed = InteractiveUpdate2(db, iss);
+        WriteInt16(oss, committed ? 0 : 1);
     } catch (std::exception& e) {
         std::cout << "interactive_update_2 exception: " << e.what() << std::endl;
         std::cout << "interactive_update_2 failed" << std::endl;
@@ -55,3 +41,4 @@ extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std
     response = oss.str();
     return true;
 }
+#endif
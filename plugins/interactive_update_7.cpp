@@ -2,115 +2,111 @@
 #include "snb_common.h"
 #include "snb_constants.h"
 
-extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std::string& response) {
-    std::stringstream oss;
-    try {
-        auto txn = db.CreateReadTxn();
-        std::string input = lgraph_api::base64::Decode(request);
-        std::stringstream iss(input);
-        int64_t comment_id = ReadInt64(iss);
-        int64_t creation_date = ReadInt64(iss);
-        std::string location_ip = ReadString(iss);
-        std::string browser_used = ReadString(iss);
-        std::string content = ReadString(iss);
-        int32_t length = ReadInt32(iss);
-        int64_t person_id = ReadInt64(iss);
-        int64_t person_vid;
-        {
-            auto fd = lgraph_api::FieldData::Int64(person_id);
-            auto iit = txn.GetVertexIndexIterator(PERSON, PERSON_ID, fd, fd);
-            person_vid = iit.GetVid();
-        }
-        int64_t country_id = ReadInt64(iss);
-        int64_t place_vid;
-        {
-            auto fd = lgraph_api::FieldData::Int64(country_id);
-            auto iit = txn.GetVertexIndexIterator(PLACE, PLACE_ID, fd, fd);
-            place_vid = iit.GetVid();
+bool InteractiveUpdate7(lgraph_api::GraphDB& db, std::stringstream& iss) {
+    int64_t comment_id = ReadInt64(iss);
+    int64_t creation_date = ReadInt64(iss);
+    std::string location_ip = ReadString(iss);
+    std::string browser_used = ReadString(iss);
+    std::string content = ReadString(iss);
+    int32_t length = ReadInt32(iss);
+    int64_t person_id = ReadInt64(iss);
+    int64_t country_id = ReadInt64(iss);
+    int64_t post_id = ReadInt64(iss);
+    int64_t original_comment_id = ReadInt64(iss);
+    int16_t num_items;
+    std::vector<int64_t> tag_ids;
+    num_items = ReadInt16(iss);
+    for (int i = 0; i < num_items; i++) {
+        tag_ids.emplace_back(ReadInt64(iss));
+    }
+    int64_t comment_vid = -1;
+    bool committed = ExecuteUpdate(db, "interactive_update_7", [&](lgraph_api::Transaction& txn) {
+        int64_t person_vid = ResolveVid(txn, PERSON, person_id);
+        int64_t place_vid = ResolveVid(txn, PLACE, country_id);
+        int64_t post_vid = post_id != -1 ? ResolveVid(txn, POST, post_id) : -1;
+        int64_t original_comment_vid =
+            original_comment_id != -1 ? ResolveVid(txn, COMMENT, original_comment_id) : -1;
+        // the reply fields are read from the parent first, so that the record is written once
+        int64_t parent_vid = post_vid != -1 ? post_vid : original_comment_vid;
+        auto parent = txn.GetVertexIterator(parent_vid);
+        int64_t friend_vid;
+        lgraph_api::FieldData root_post, root_forum;
+        if (post_vid != -1) {
+            friend_vid = parent[POST_CREATOR].integer();
+            root_post = lgraph_api::FieldData::Int64(post_vid);
+            root_forum = parent[POST_CONTAINER];
+            Vertex<POST>::Increment<POST_REPLYCOUNT>(parent, 1);
+        } else {
+            friend_vid = parent[COMMENT_CREATOR].integer();
+            root_post = parent[COMMENT_ROOTPOST];
+            root_forum = parent[COMMENT_ROOTFORUM];
+            Vertex<COMMENT>::Increment<COMMENT_REPLYCOUNT>(parent, 1);
         }
-        int64_t post_id = ReadInt64(iss);
-        int64_t post_vid = -1;
-        if (post_id != -1) {
-            auto fd = lgraph_api::FieldData::Int64(post_id);
-            auto iit = txn.GetVertexIndexIterator(POST, POST_ID, fd, fd);
-            post_vid = iit.GetVid();
+        comment_vid =
+            txn.AddVertex(COMMENT,
+                          {COMMENT_ID, COMMENT_CREATIONDATE, COMMENT_LOCATIONIP, COMMENT_BROWSERUSED,
+                           COMMENT_CONTENT, COMMENT_LENGTH, COMMENT_CREATOR, COMMENT_PLACE, COMMENT_LIKECOUNT,
+                           COMMENT_REPLYCOUNT, size_t(post_vid != -1 ? COMMENT_REPLYOFPOST : COMMENT_REPLYOFCOMMENT),
+                           COMMENT_ROOTPOST, COMMENT_ROOTFORUM},
+                          {lgraph_api::FieldData::Int64(comment_id), lgraph_api::FieldData::Int64(creation_date),
+                           lgraph_api::FieldData::String(location_ip), lgraph_api::FieldData::String(browser_used),
+                           lgraph_api::FieldData::String(content), lgraph_api::FieldData::Int32(length),
+                           lgraph_api::FieldData::Int64(person_vid), lgraph_api::FieldData::Int64(place_vid),
+                           lgraph_api::FieldData::Int32(0), lgraph_api::FieldData::Int32(0),
+                           lgraph_api::FieldData::Int64(parent_vid), root_post, root_forum});
+        txn.AddEdge(comment_vid, parent_vid, REPLYOF, {REPLYOF_CREATIONDATE},
+                    {lgraph_api::FieldData::Int64(creation_date)});
+        txn.AddEdge(comment_vid, person_vid, COMMENTHASCREATOR, {COMMENTHASCREATOR_CREATIONDATE},
+                    {lgraph_api::FieldData::Int64(creation_date)});
+        txn.AddEdge(comment_vid, place_vid, COMMENTISLOCATEDIN, {COMMENTISLOCATEDIN_CREATIONDATE},
+                    {lgraph_api::FieldData::Int64(creation_date)});
+        for (auto& tag_id : tag_ids) {
+            txn.AddEdge(comment_vid, ResolveVid(txn, TAG, tag_id), COMMENTHASTAG, {}, {});
         }
-        int64_t original_comment_id = ReadInt64(iss);
-        int64_t original_comment_vid = -1;
-        if (original_comment_id != -1) {
-            auto fd = lgraph_api::FieldData::Int64(original_comment_id);
-            auto iit = txn.GetVertexIndexIterator(COMMENT, COMMENT_ID, fd, fd);
-            original_comment_vid = iit.GetVid();
+        auto eit = txn.GetOutEdgeIterator(lgraph_api::EdgeUid(person_vid, friend_vid, KNOWS, 0, 0));
+        bool ok = false;
+        if (eit.IsValid()) {
+            ok = true;
+        } else {
+            eit.Goto(lgraph_api::EdgeUid(friend_vid, person_vid, KNOWS, 0, 0));
+            ok = eit.IsValid();
         }
-        int16_t num_items;
-        std::vector<int64_t> tag_vids;
-        num_items = ReadInt16(iss);
-        for (int i = 0; i < num_items; i++) {
-            int64_t tag_id = ReadInt64(iss);
-            auto fd = lgraph_api::FieldData::Int64(tag_id);
-            auto iit = txn.GetVertexIndexIterator(TAG, TAG_ID, fd, fd);
-            int64_t tag_vid = iit.GetVid();
-            tag_vids.emplace_back(tag_vid);
+        double weight = (post_vid != -1) ? 1.0 : 0.5;
+        if (ok) {
+            Edge<KNOWS>::Increment<KNOWS_WEIGHT>(eit, weight);
         }
-        bool committed = false;
-        try {
-            txn.Abort();
-            txn = db.CreateWriteTxn();
-            int64_t comment_vid =
-                txn.AddVertex(COMMENT,
-                              {COMMENT_ID, COMMENT_CREATIONDATE, COMMENT_LOCATIONIP, COMMENT_BROWSERUSED,
-                               COMMENT_CONTENT, COMMENT_LENGTH, COMMENT_CREATOR, COMMENT_PLACE},
-                              {lgraph_api::FieldData::Int64(comment_id), lgraph_api::FieldData::Int64(creation_date),
-                               lgraph_api::FieldData::String(location_ip), lgraph_api::FieldData::String(browser_used),
-                               lgraph_api::FieldData::String(content), lgraph_api::FieldData::Int32(length),
-                               lgraph_api::FieldData::Int64(person_vid), lgraph_api::FieldData::Int64(place_vid)});
-            auto comment = txn.GetVertexIterator(comment_vid);
-            int64_t friend_vid;
-            if (post_vid != -1) {
-                comment.SetField(COMMENT_REPLYOFPOST, lgraph_api::FieldData::Int64(post_vid));
-                txn.AddEdge(comment_vid, post_vid, REPLYOF, {REPLYOF_CREATIONDATE},
-                            {lgraph_api::FieldData::Int64(creation_date)});
-                auto post = txn.GetVertexIterator(post_vid);
-                friend_vid = post[POST_CREATOR].integer();
+        if (friend_vid != person_vid) {
+            auto interaction =
+                txn.GetOutEdgeIterator(lgraph_api::EdgeUid(person_vid, friend_vid, INTERACTION, 0, 0));
+            if (interaction.IsValid()) {
+                Edge<INTERACTION>::Increment<INTERACTION_WEIGHT>(interaction, weight);
             } else {
-                comment.SetField(COMMENT_REPLYOFCOMMENT, lgraph_api::FieldData::Int64(original_comment_vid));
-                txn.AddEdge(comment_vid, original_comment_vid, REPLYOF, {REPLYOF_CREATIONDATE},
-                            {lgraph_api::FieldData::Int64(creation_date)});
-                auto original_comment = txn.GetVertexIterator(original_comment_vid);
-                friend_vid = original_comment[COMMENT_CREATOR].integer();
+                txn.AddEdge(person_vid, friend_vid, INTERACTION, {INTERACTION_WEIGHT},
+                            {lgraph_api::FieldData::Double(weight)});
             }
-            txn.AddEdge(comment_vid, person_vid, COMMENTHASCREATOR, {COMMENTHASCREATOR_CREATIONDATE},
-                        {lgraph_api::FieldData::Int64(creation_date)});
-            txn.AddEdge(comment_vid, place_vid, COMMENTISLOCATEDIN, {COMMENTISLOCATEDIN_CREATIONDATE},
-                        {lgraph_api::FieldData::Int64(creation_date)});
-            for (auto& tag_vid : tag_vids) {
-                txn.AddEdge(comment_vid, tag_vid, COMMENTHASTAG, {}, {});
-            }
-            auto eit = txn.GetOutEdgeIterator(lgraph_api::EdgeUid(person_vid, friend_vid, KNOWS, 0, 0));
-            bool ok = false;
-            if (eit.IsValid()) {
-                ok = true;
-            } else {
-                eit.Goto(lgraph_api::EdgeUid(friend_vid, person_vid, KNOWS, 0, 0));
-                ok = eit.IsValid();
-            }
-            if (ok) {
-                eit.SetField(KNOWS_WEIGHT,
-                             lgraph_api::FieldData::Double(eit[KNOWS_WEIGHT].real() + ((post_vid != -1) ? 1.0 : 0.5)));
-            }
-            auto person = txn.GetVertexIterator(person_vid);
-            person.SetField(PERSON_CREATIONDATE, person[PERSON_CREATIONDATE]);
-            txn.Commit();
-            committed = true;
-        } catch (std::exception& e) {
-            std::cout << "interactive_update_7 exception: " << e.what() << std::endl;
         }
-        if (committed) {
-            WriteInt16(oss, 0);
-        } else {
-            std::cout << "interactive_update_7 failed" << std::endl;
-            WriteInt16(oss, 1);
+        auto replied_person = txn.GetVertexIterator(friend_vid);
+        auto recent_replies = UnpackRecords<RecentReply>(replied_person[PERSON_RECENTREPLIES]);
+        if (OfferRecentReply(recent_replies, RecentReply{creation_date, comment_id, comment_vid, person_vid})) {
+            replied_person.SetField(PERSON_RECENTREPLIES, PackRecords(recent_replies));
         }
+        DeclareWriteIntent(txn, person_vid);
+        NotifyWrite(person_vid);
+        NotifyWrite(post_vid != -1 ? post_vid : original_comment_vid);
+        NotifyWrite(friend_vid);
+    });
+    if (committed) VidCache::Of(COMMENT).Insert(comment_id, comment_vid);
+    return committed;
+}
+
+#ifndef INTERACTIVE_APPLY_UPDATES
+extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std::string& response) {
+    std::stringstream oss;
+    try {
+        std::string input = lgraph_api::base64::Decode(request);
+        std::stringstream iss(input);
+        bool committed = InteractiveUpdate7(db, iss);
+        WriteInt16(oss, committed ? 0 : 1);
     } catch (std::exception& e) {
         std::cout << "interactive_update_7 exception: " << e.what() << std::endl;
         std::cout << "interactive_update_7 failed" << std::endl;
@@ -119,3 +115,4 @@ extern "C" bool Process(lgraph_api::GraphDB& db, const std::string& request, std
     response = oss.str();
     return true;
 }
+#endif
@@ -107,6 +107,7 @@ void AddIndices(GraphDB& db) {
     double exec_time = - omp_get_wtime();
 
     std::vector< std::tuple<std::string, std::string, bool> > index_list{
+        std::make_tuple("Person", "firstName", false),
         std::make_tuple("Place", "name", false),
         std::make_tuple("Tag", "name", true),
         std::make_tuple("Tagclass", "name", true)
@@ -133,6 +134,7 @@ void FillInFields(GraphDB& db) {
 
     std::vector< std::tuple<int64_t, int64_t, int32_t> > forum_hasmember_person_edges;
     std::vector< std::tuple<int64_t, int64_t, double> > person_knows_person_edges;
+    std::vector< std::tuple<int64_t, int64_t, double> > person_interaction_person_edges;
 
     worker->Delegate([&](){
         constexpr size_t threshold = 256;
@@ -142,6 +144,7 @@ void FillInFields(GraphDB& db) {
         {
             std::vector< std::tuple<int64_t, int64_t, int32_t> > forum_hasmember_person_edges_;
             std::vector< std::tuple<int64_t, int64_t, double> > person_knows_person_edges_;
+            std::vector< std::tuple<int64_t, int64_t, double> > person_interaction_person_edges_;
             auto txn = db.CreateReadTxn();
             while (true) {
                 size_t chunk_begin = __sync_fetch_and_add(&cursor, chunk_size);
@@ -155,16 +158,19 @@ void FillInFields(GraphDB& db) {
                         case PERSON: {
                             auto& person = vit;
                             std::unordered_map< int64_t, int32_t > post_count;
+                            std::vector<int64_t> post_vids;
                             for (auto person_posts = lgraph_api::LabeledInEdgeIterator(person, POSTHASCREATOR); person_posts.IsValid(); person_posts.Next()) {
-                                auto post = txn.GetVertexIterator(person_posts.GetSrc());
-                                int64_t forum_vid = post[POST_CONTAINER].integer();
+                                post_vids.emplace_back(person_posts.GetSrc());
+                            }
+                            FetchVertices(txn, post_vids, {POST_CONTAINER}, [&](size_t i, const std::vector<FieldData>& values) {
+                                int64_t forum_vid = values[0].integer();
                                 auto it = post_count.find(forum_vid);
                                 if (it != post_count.end()) {
                                     it->second += 1;
                                 } else {
                                     post_count.emplace(forum_vid, 1);
                                 }
-                            }
+                            });
                             std::unordered_map< int64_t, double > weight_info;
                             for (auto person_comments = lgraph_api::LabeledInEdgeIterator(person, COMMENTHASCREATOR); person_comments.IsValid(); person_comments.Next()) {
                                 auto comment = txn.GetVertexIterator(person_comments.GetSrc());
@@ -211,6 +217,7 @@ void FillInFields(GraphDB& db) {
                             for (auto it = weight_info.begin(); it != weight_info.end(); it ++) {
                                 int64_t person_vid = it->first;
                                 double weight = it->second;
+                                if (person_vid != (int64_t)vid) person_interaction_person_edges_.emplace_back(vid, person_vid, weight);
                                 auto oeit = person.GetOutEdgeIterator(lgraph_api::EdgeUid(vid, person_vid, KNOWS, 0, 0));
                                 if (oeit.IsValid()) {
                                     person_knows_person_edges_.emplace_back(vid, person_vid, weight);
@@ -228,8 +235,10 @@ void FillInFields(GraphDB& db) {
                             }
                             mutex.lock();
                             person_knows_person_edges.insert(person_knows_person_edges.end(), person_knows_person_edges_.begin(), person_knows_person_edges_.end());
+                            person_interaction_person_edges.insert(person_interaction_person_edges.end(), person_interaction_person_edges_.begin(), person_interaction_person_edges_.end());
                             mutex.unlock();
                             person_knows_person_edges_.clear();
+                            person_interaction_person_edges_.clear();
                             break;
                         }
                         default: {
@@ -271,6 +280,267 @@ void FillInFields(GraphDB& db) {
         }
     }
     if (txn.IsValid()) txn.Commit();
+    // interaction edges hold the reply weight of every (replier, replied-to person) pair, friends or not, so that
+    // Update 8 can initialize knows.weight from two edges
+    txn = db.CreateWriteTxn();
+    std::sort(person_interaction_person_edges.begin(), person_interaction_person_edges.end());
+    for (size_t i = 0; i < person_interaction_person_edges.size(); i ++) {
+        int64_t src, dst;
+        double weight;
+        std::tie(src, dst, weight) = person_interaction_person_edges[i];
+        txn.AddEdge(src, dst, INTERACTION, {INTERACTION_WEIGHT}, {FieldData::Double(weight)});
+        if (i % batch_size == batch_size - 1) {
+            txn.Commit();
+            txn = db.CreateWriteTxn();
+        }
+    }
+    if (txn.IsValid()) txn.Commit();
+
+    exec_time += omp_get_wtime();
+
+    std::cout << exec_time << std::endl;
+}
+
+// a pass of its own rather than part of FillInFields, which buffers its writes and would need one per message
+void FillInMessageCounts(GraphDB& db) {
+    double exec_time = - omp_get_wtime();
+
+    auto worker = lgraph_api::olap::Worker::SharedWorker();
+
+    size_t num_vertices = db.EstimateNumVertices();
+
+    worker->Delegate([&](){
+        constexpr size_t chunk_size = 64;
+        size_t cursor = 0;
+        #pragma omp parallel
+        {
+            while (true) {
+                size_t chunk_begin = __sync_fetch_and_add(&cursor, chunk_size);
+                if (chunk_begin >= num_vertices) break;
+                size_t chunk_end = chunk_begin + chunk_size;
+                auto txn = db.CreateWriteTxn(true);
+                auto vit = txn.GetVertexIterator(chunk_begin, true);
+                while (vit.IsValid()) {
+                    size_t vid = vit.GetId();
+                    if (vid >= chunk_end) break;
+                    size_t lid = vit.GetLabelId();
+                    if (lid == POST || lid == COMMENT) {
+                        int32_t like_count = 0;
+                        int32_t reply_count = 0;
+                        for (auto likes = lgraph_api::LabeledInEdgeIterator(vit, LIKES); likes.IsValid(); likes.Next()) like_count ++;
+                        for (auto replies = lgraph_api::LabeledInEdgeIterator(vit, REPLYOF); replies.IsValid(); replies.Next()) reply_count ++;
+                        if (lid == POST) {
+                            vit.SetFields({POST_LIKECOUNT, POST_REPLYCOUNT}, {FieldData::Int32(like_count), FieldData::Int32(reply_count)});
+                        } else {
+                            vit.SetFields({COMMENT_LIKECOUNT, COMMENT_REPLYCOUNT}, {FieldData::Int32(like_count), FieldData::Int32(reply_count)});
+                        }
+                    }
+                    vit.Next();
+                }
+                txn.Commit();
+            }
+        }
+    });
+
+    exec_time += omp_get_wtime();
+
+    std::cout << exec_time << std::endl;
+}
+
+void AddWorkInCountryEdges(GraphDB& db) {
+    double exec_time = - omp_get_wtime();
+
+    auto worker = lgraph_api::olap::Worker::SharedWorker();
+
+    size_t num_vertices = db.EstimateNumVertices();
+
+    std::mutex mutex;
+
+    std::vector< std::tuple<int64_t, int64_t, int64_t, int64_t> > person_workincountry_place_edges;
+
+    worker->Delegate([&](){
+        constexpr size_t chunk_size = 64;
+        size_t cursor = 0;
+        #pragma omp parallel
+        {
+            std::vector< std::tuple<int64_t, int64_t, int64_t, int64_t> > person_workincountry_place_edges_;
+            auto txn = db.CreateReadTxn();
+            auto company = txn.GetVertexIterator();
+            while (true) {
+                size_t chunk_begin = __sync_fetch_and_add(&cursor, chunk_size);
+                if (chunk_begin >= num_vertices) break;
+                size_t chunk_end = chunk_begin + chunk_size;
+                if (chunk_end > num_vertices) chunk_end = num_vertices;
+                for (size_t vid = chunk_begin; vid < chunk_end; vid ++) {
+                    auto vit = txn.GetVertexIterator(vid);
+                    if (vit.GetLabelId() != PERSON) continue;
+                    for (auto person_work_at = lgraph_api::LabeledOutEdgeIterator(vit, WORKAT); person_work_at.IsValid(); person_work_at.Next()) {
+                        auto work_from = person_work_at[WORKAT_WORKFROM];
+                        if (work_from.is_null()) continue;
+                        company.Goto(person_work_at.GetDst());
+                        person_workincountry_place_edges_.emplace_back(vid, company[ORGANISATION_PLACE].integer(), work_from.integer(), company.GetId());
+                    }
+                }
+            }
+            mutex.lock();
+            person_workincountry_place_edges.insert(person_workincountry_place_edges.end(), person_workincountry_place_edges_.begin(), person_workincountry_place_edges_.end());
+            mutex.unlock();
+        }
+    });
+
+    constexpr size_t batch_size = 1024;
+    auto txn = db.CreateWriteTxn();
+    std::sort(person_workincountry_place_edges.begin(), person_workincountry_place_edges.end());
+    for (size_t i = 0; i < person_workincountry_place_edges.size(); i ++) {
+        int64_t src, dst, work_from, organisation;
+        std::tie(src, dst, work_from, organisation) = person_workincountry_place_edges[i];
+        txn.AddEdge(src, dst, WORKINCOUNTRY, {WORKINCOUNTRY_WORKFROM, WORKINCOUNTRY_ORGANISATION}, {FieldData::Int64(work_from), FieldData::Int64(organisation)});
+        if (i % batch_size == batch_size - 1) {
+            txn.Commit();
+            txn = db.CreateWriteTxn();
+        }
+    }
+    if (txn.IsValid()) txn.Commit();
+
+    exec_time += omp_get_wtime();
+
+    std::cout << exec_time << std::endl;
+}
+
+void FillInRoots(GraphDB& db) {
+    double exec_time = - omp_get_wtime();
+
+    auto worker = lgraph_api::olap::Worker::SharedWorker();
+
+    size_t num_vertices = db.EstimateNumVertices();
+
+    std::mutex mutex;
+
+    std::vector< std::tuple<int64_t, int64_t, int64_t> > comment_roots;
+
+    // every reply tree is walked from its post by the chunk containing the post; the comments it reaches lie anywhere,
+    // so they are collected here and written in vid order afterwards
+    worker->Delegate([&](){
+        constexpr size_t chunk_size = 64;
+        size_t cursor = 0;
+        #pragma omp parallel
+        {
+            std::vector< std::tuple<int64_t, int64_t, int64_t> > comment_roots_;
+            std::vector<int64_t> stack;
+            auto txn = db.CreateReadTxn();
+            while (true) {
+                size_t chunk_begin = __sync_fetch_and_add(&cursor, chunk_size);
+                if (chunk_begin >= num_vertices) break;
+                size_t chunk_end = chunk_begin + chunk_size;
+                auto vit = txn.GetVertexIterator(chunk_begin, true);
+                while (vit.IsValid()) {
+                    size_t vid = vit.GetId();
+                    if (vid >= chunk_end) break;
+                    if (vit.GetLabelId() == POST) {
+                        auto& post = vit;
+                        int64_t forum_vid = post[POST_CONTAINER].integer();
+                        stack.emplace_back(vid);
+                        while (!stack.empty()) {
+                            int64_t parent_vid = stack.back();
+                            stack.pop_back();
+                            for (auto replies = lgraph_api::LabeledInEdgeIterator(txn, parent_vid, REPLYOF); replies.IsValid(); replies.Next()) {
+                                int64_t comment_vid = replies.GetSrc();
+                                comment_roots_.emplace_back(comment_vid, vid, forum_vid);
+                                stack.emplace_back(comment_vid);
+                            }
+                        }
+                    }
+                    vit.Next();
+                }
+            }
+            mutex.lock();
+            comment_roots.insert(comment_roots.end(), comment_roots_.begin(), comment_roots_.end());
+            mutex.unlock();
+        }
+    });
+
+    constexpr size_t batch_size = 1024;
+    auto txn = db.CreateWriteTxn();
+    std::sort(comment_roots.begin(), comment_roots.end());
+    for (size_t i = 0; i < comment_roots.size(); i ++) {
+        int64_t comment_vid, post_vid, forum_vid;
+        std::tie(comment_vid, post_vid, forum_vid) = comment_roots[i];
+        auto comment = txn.GetVertexIterator(comment_vid);
+        comment.SetFields({COMMENT_ROOTPOST, COMMENT_ROOTFORUM}, {FieldData::Int64(post_vid), FieldData::Int64(forum_vid)});
+        if (i % batch_size == batch_size - 1) {
+            txn.Commit();
+            txn = db.CreateWriteTxn();
+        }
+    }
+    if (txn.IsValid()) txn.Commit();
+
+    exec_time += omp_get_wtime();
+
+    std::cout << exec_time << std::endl;
+}
+
+void FillInPersonViews(GraphDB& db) {
+    double exec_time = - omp_get_wtime();
+
+    auto worker = lgraph_api::olap::Worker::SharedWorker();
+
+    size_t num_vertices = db.EstimateNumVertices();
+
+    worker->Delegate([&](){
+        constexpr size_t chunk_size = 64;
+        size_t cursor = 0;
+        #pragma omp parallel
+        {
+            while (true) {
+                size_t chunk_begin = __sync_fetch_and_add(&cursor, chunk_size);
+                if (chunk_begin >= num_vertices) break;
+                size_t chunk_end = chunk_begin + chunk_size;
+                auto txn = db.CreateWriteTxn(true);
+                auto vit = txn.GetVertexIterator(chunk_begin, true);
+                auto message = txn.GetVertexIterator();
+                auto liker = txn.GetVertexIterator();
+                auto reply = txn.GetVertexIterator();
+                while (vit.IsValid()) {
+                    size_t vid = vit.GetId();
+                    if (vid >= chunk_end) break;
+                    if (vit.GetLabelId() == PERSON) {
+                        auto& person = vit;
+                        std::vector<RecentLike> recent_likers;
+                        std::vector<RecentReply> recent_replies;
+                        auto offer_likes_and_replies = [&](int64_t message_vid, int64_t message_id) {
+                            for (auto message_likes = lgraph_api::LabeledInEdgeIterator(txn, message_vid, LIKES); message_likes.IsValid(); message_likes.Next()) {
+                                int64_t creation_date = message_likes[LIKES_CREATIONDATE].integer();
+                                if (recent_likers.size() >= RECENT_LIKERS_LIMIT && creation_date < recent_likers.back().creation_date) continue;
+                                int64_t liker_vid = message_likes.GetSrc();
+                                liker.Goto(liker_vid);
+                                OfferRecentLike(recent_likers, RecentLike{creation_date, liker[PERSON_ID].integer(), liker_vid, message_id, message_vid});
+                            }
+                            for (auto message_replies = lgraph_api::LabeledInEdgeIterator(txn, message_vid, REPLYOF); message_replies.IsValid(); message_replies.Next()) {
+                                int64_t creation_date = message_replies[REPLYOF_CREATIONDATE].integer();
+                                if (recent_replies.size() >= RECENT_REPLIES_LIMIT && creation_date < recent_replies.back().creation_date) continue;
+                                int64_t comment_vid = message_replies.GetSrc();
+                                reply.Goto(comment_vid);
+                                OfferRecentReply(recent_replies, RecentReply{creation_date, reply[COMMENT_ID].integer(), comment_vid, reply[COMMENT_CREATOR].integer()});
+                            }
+                        };
+                        for (auto person_posts = lgraph_api::LabeledInEdgeIterator(person, POSTHASCREATOR); person_posts.IsValid(); person_posts.Next()) {
+                            message.Goto(person_posts.GetSrc());
+                            offer_likes_and_replies(message.GetId(), message[POST_ID].integer());
+                        }
+                        for (auto person_comments = lgraph_api::LabeledInEdgeIterator(person, COMMENTHASCREATOR); person_comments.IsValid(); person_comments.Next()) {
+                            message.Goto(person_comments.GetSrc());
+                            offer_likes_and_replies(message.GetId(), message[COMMENT_ID].integer());
+                        }
+                        if (!recent_likers.empty() || !recent_replies.empty()) {
+                            person.SetFields({PERSON_RECENTLIKERS, PERSON_RECENTREPLIES}, {PackRecords(recent_likers), PackRecords(recent_replies)});
+                        }
+                    }
+                    vit.Next();
+                }
+                txn.Commit();
+            }
+        }
+    });
 
     exec_time += omp_get_wtime();
 
@@ -286,6 +556,10 @@ int main(int argc, char** argv) {
     ConvertForeignKeys(db);
     AddIndices(db);
     FillInFields(db);
+    FillInMessageCounts(db);
+    AddWorkInCountryEdges(db);
+    FillInRoots(db);
+    FillInPersonViews(db);
 
     return 0;
 }
@@ -0,0 +1,117 @@
+#define SHORT_READ_CACHE
+#define SHORT_READ_CACHE_SHM "/tugraph_snb_epochs_stress"
+#define SHORT_READ_CACHE_REPORT_INTERVAL (1ull << 62)
+
+#include "lgraph/lgraph.h"
+
+#include "snb_constants.h"
+#include "snb_common.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Concurrent updates against cached short reads, on a scratch database like acid. Writers bump the version of random
+// accounts through ExecuteUpdate and publish each version once it is committed; readers read an account through
+// ProcessShortRead and check that the response is not older than the version published before the read started.
+// Exits with 1 on a stale read.
+//   ./short_read_cache_stress [db_path] [num_writers] [num_readers] [num_accounts] [seconds]
+
+int main(int argc, char** argv) {
+    std::string db_path(argc > 1 ? argv[1] : "./stressdb");
+    int num_writers = argc > 2 ? std::stoi(argv[2]) : 8;
+    int num_readers = argc > 3 ? std::stoi(argv[3]) : 16;
+    int num_accounts = argc > 4 ? std::stoi(argv[4]) : 64;
+    double seconds = argc > 5 ? std::stod(argv[5]) : 30;
+
+    lgraph_api::Galaxy galaxy(db_path, "admin", "73@TuGraph", false, true);
+    auto db = galaxy.OpenGraph("default");
+    db.DropAllData();
+    bool ok = db.AddVertexLabel("Account", {
+        {"id", lgraph_api::FieldType::INT64, false},
+        {"version", lgraph_api::FieldType::INT64, false}
+    }, "id");
+    if (!ok) throw std::runtime_error("failed to register label Account");
+
+    std::vector<int64_t> vids;
+    size_t version_fid;
+    {
+        auto txn = db.CreateWriteTxn();
+        version_fid = txn.GetVertexFieldId(txn.GetVertexLabelId("Account"), "version");
+        for (int64_t id = 0; id < num_accounts; id ++) {
+            vids.emplace_back(txn.AddVertex("Account", {"id", "version"},
+                                            {lgraph_api::FieldData::Int64(id), lgraph_api::FieldData::Int64(0)}));
+        }
+        txn.Commit();
+    }
+    std::vector< std::atomic<int64_t> > published(num_accounts);
+    for (auto& version : published) version = 0;
+
+    auto read = [&](lgraph_api::GraphDB& db, lgraph_api::Transaction& txn, std::stringstream& iss,
+                    std::stringstream& oss) {
+        int64_t account = ReadInt64(iss);
+        DependOn(vids[account]);
+        auto vit = txn.GetVertexIterator(vids[account]);
+        WriteInt64(oss, vit[version_fid].integer());
+    };
+
+    std::atomic<uint64_t> num_reads{0};
+    std::atomic<uint64_t> num_updates{0};
+    std::atomic<uint64_t> num_stale{0};
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(int64_t(seconds * 1e6));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_writers; t ++) {
+        threads.emplace_back([&, t]() {
+            std::minstd_rand rng(t);
+            std::uniform_int_distribution<int64_t> pick(0, num_accounts - 1);
+            while (std::chrono::steady_clock::now() < deadline) {
+                int64_t account = pick(rng);
+                int64_t version = 0;
+                bool committed = ExecuteUpdate(db, "short_read_cache_stress", [&](lgraph_api::Transaction& txn) {
+                    auto vit = txn.GetVertexIterator(vids[account]);
+                    version = vit[version_fid].integer() + 1;
+                    vit.SetField(version_fid, lgraph_api::FieldData::Int64(version));
+                    NotifyWrite(vids[account]);
+                });
+                if (!committed) continue;
+                int64_t last = published[account].load();
+                while (last < version && !published[account].compare_exchange_weak(last, version)) {
+                }
+                num_updates ++;
+            }
+        });
+    }
+    for (int t = 0; t < num_readers; t ++) {
+        threads.emplace_back([&, t]() {
+            std::minstd_rand rng(num_writers + t);
+            std::uniform_int_distribution<int64_t> pick(0, num_accounts - 1);
+            while (std::chrono::steady_clock::now() < deadline) {
+                int64_t account = pick(rng);
+                int64_t expected = published[account].load();
+                std::stringstream request;
+                WriteInt64(request, account);
+                std::string response;
+                ProcessShortRead(db, "short_read_cache_stress", lgraph_api::base64::Encode(request.str()), response,
+                                 read);
+                std::stringstream iss(response);
+                int64_t version = ReadInt64(iss);
+                if (version < expected) {
+                    num_stale ++;
+                    std::cout << "stale read of account " << account << ": version " << version << " after "
+                              << expected << " was committed" << std::endl;
+                }
+                num_reads ++;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    ResultCache::Get().Report("short_read_cache_stress");
+    std::cout << "updates=" << num_updates.load() << " reads=" << num_reads.load() << " stale=" << num_stale.load()
+              << std::endl;
+    return num_stale.load() == 0 ? 0 : 1;
+}
@@ -1,5 +1,62 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <random>
 #include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "lgraph/lgraph.h"
+#include "snb_constants.h"
+#include "snb_schema.h"
+
+// One line of a procedure's log on stdout, which the server captures: the procedure name, then what is streamed into
+// it, written with a single call so that lines of concurrent calls do not interleave.
+class PluginLog {
+    std::ostringstream line_;
+
+   public:
+    explicit PluginLog(const char* name) { line_ << name << " "; }
+
+    PluginLog(const PluginLog&) = delete;
+
+    PluginLog& operator=(const PluginLog&) = delete;
+
+    ~PluginLog() {
+        line_ << '\n';
+        std::cout << line_.str() << std::flush;
+    }
+
+    template <typename T>
+    PluginLog& operator<<(const T& value) {
+        line_ << value;
+        return *this;
+    }
+};
 
 inline int16_t ReadInt16(std::stringstream& iss) {
     int16_t i;
@@ -46,55 +103,92 @@ inline void WriteString(std::stringstream& oss, const std::string& s) {
 
 inline void WriteBool(std::stringstream& oss, bool b) { oss.write((const char*)&b, sizeof(bool)); }
 
-#include <tuple>
-#include "date/date.h"
+// INT32-length framed bytes, for nested requests/responses that may exceed the INT16 length of a string
+inline std::string ReadFrame(std::stringstream& iss) {
+    int32_t len = ReadInt32(iss);
+    if (!iss || len < 0) throw std::runtime_error("truncated frame");
+    std::string s;
+    s.resize(len);
+    iss.read((char*)s.data(), s.size());
+    if (!iss) throw std::runtime_error("truncated frame");
+    return s;
+}
+
+inline void WriteFrame(std::stringstream& oss, const std::string& s) {
+    WriteInt32(oss, s.size());
+    oss.write((const char*)s.data(), s.size());
+}
+
+
+// Days-to-civil conversion after Howard Hinnant's civil_from_days, written without branches so that the batch
+// variants below vectorize. Timestamps are milliseconds since the epoch (UTC).
+constexpr int64_t FloorDiv(int64_t a, int64_t b) { return a / b - (a % b < 0); }
+
+struct CivilDate {
+    int32_t year;
+    int32_t month;
+    int32_t day;
+};
+
+constexpr CivilDate CivilFromDays(int64_t days) {
+    const int64_t z = days + 719468;
+    const int64_t era = FloorDiv(z, 146097);
+    const int64_t doe = z - era * 146097;
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int64_t mp = (5 * doy + 2) / 153;
+    const int32_t day = doy - (153 * mp + 2) / 5 + 1;
+    const int32_t month = mp + 3 - 12 * (mp >= 10);
+    return CivilDate{static_cast<int32_t>(yoe + era * 400 + (month <= 2)), month, day};
+}
+
+constexpr CivilDate CivilFromTimestamp(int64_t ts) { return CivilFromDays(FloorDiv(ts, 86400000)); }
+
+static_assert(CivilFromDays(0).year == 1970 && CivilFromDays(0).month == 1 && CivilFromDays(0).day == 1, "");
+static_assert(CivilFromDays(11016).year == 2000 && CivilFromDays(11016).month == 2 && CivilFromDays(11016).day == 29,
+              "");
+static_assert(CivilFromDays(-1).year == 1969 && CivilFromDays(-1).month == 12 && CivilFromDays(-1).day == 31, "");
 
 inline std::tuple<int32_t, int32_t, int32_t> GetYearMonthDay(int64_t ts) {
-    auto tp = std::chrono::system_clock::time_point(std::chrono::seconds(ts / 1000));
-    auto dp = date::floor<date::days>(tp);
-    auto ymd = date::year_month_day(dp);
-    int32_t year = (int)ymd.year();
-    int32_t month = (unsigned)ymd.month();
-    int32_t day = (unsigned)ymd.day();
-    return std::make_tuple(year, month, day);
+    auto date = CivilFromTimestamp(ts);
+    return std::make_tuple(date.year, date.month, date.day);
 }
 
 inline std::pair<int32_t, int32_t> GetYearMonth(int64_t ts) {
-    auto tp = std::chrono::system_clock::time_point(std::chrono::seconds(ts / 1000));
-    auto dp = date::floor<date::days>(tp);
-    auto ymd = date::year_month_day(dp);
-    int32_t year = (int)ymd.year();
-    int32_t month = (unsigned)ymd.month();
-    return std::make_pair(year, month);
+    auto date = CivilFromTimestamp(ts);
+    return std::make_pair(date.year, date.month);
 }
 
 inline std::pair<int32_t, int32_t> GetMonthDay(int64_t ts) {
-    auto tp = std::chrono::system_clock::time_point(std::chrono::seconds(ts / 1000));
-    auto dp = date::floor<date::days>(tp);
-    auto ymd = date::year_month_day(dp);
-    int32_t month = (unsigned)ymd.month();
-    int32_t day = (unsigned)ymd.day();
-    return std::make_pair(month, day);
+    auto date = CivilFromTimestamp(ts);
+    return std::make_pair(date.month, date.day);
 }
 
-inline int32_t GetYear(int64_t ts) {
-    auto tp = std::chrono::system_clock::time_point(std::chrono::seconds(ts / 1000));
-    auto dp = date::floor<date::days>(tp);
-    auto ymd = date::year_month_day(dp);
-    int32_t year = (int)ymd.year();
-    return year;
+inline int32_t GetYear(int64_t ts) { return CivilFromTimestamp(ts).year; }
+
+inline int32_t GetMonth(int64_t ts) { return CivilFromTimestamp(ts).month; }
+
+// (month, day) packed as month * 32 + day, so that calendar ranges within a year become integer ranges
+constexpr int32_t MonthDayOrdinal(int32_t month, int32_t day) { return month * 32 + day; }
+
+inline int32_t GetMonthDayOrdinal(int64_t ts) {
+    auto date = CivilFromTimestamp(ts);
+    return MonthDayOrdinal(date.month, date.day);
 }
 
-inline int32_t GetMonth(int64_t ts) {
-    auto tp = std::chrono::system_clock::time_point(std::chrono::seconds(ts / 1000));
-    auto dp = date::floor<date::days>(tp);
-    auto ymd = date::year_month_day(dp);
-    int32_t month = (unsigned)ymd.month();
-    return month;
+inline void GetYears(const int64_t* ts, size_t n, int32_t* years) {
+#pragma omp simd
+    for (size_t i = 0; i < n; i++) years[i] = CivilFromTimestamp(ts[i]).year;
+}
+
+inline void GetMonthDayOrdinals(const int64_t* ts, size_t n, int32_t* ordinals) {
+#pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        auto date = CivilFromTimestamp(ts[i]);
+        ordinals[i] = MonthDayOrdinal(date.month, date.day);
+    }
 }
 
-#include <type_traits>
-#include "lgraph/lgraph.h"
 
 namespace lgraph_api {
 
@@ -151,3 +245,1141 @@ static LabeledEdgeIterator<InEdgeIterator> LabeledInEdgeIterator(Transaction& tx
 }
 
 }  // namespace lgraph_api
+
+// String field helpers for vertex and edge iterators. The plugin API only hands out fields boxed in a FieldData, so
+// they cannot read the record in place, but they use the boxed string directly instead of copying it out.
+
+// Compares a STRING field against value; a null field equals nothing.
+template <typename It>
+inline bool StringEquals(const It& it, size_t fid, const std::string& value) {
+    auto fd = it.GetField(fid);
+    return !fd.is_null() && fd.string() == value;
+}
+
+// Serializes a STRING field straight from its box.
+template <typename It>
+inline void WriteStringField(std::stringstream& oss, const It& it, size_t fid) {
+    auto fd = it.GetField(fid);
+    WriteString(oss, fd.string());
+}
+
+
+// Typed views over iterators positioned at a LABEL vertex or edge, e.g. Vertex<PERSON>::Get<PERSON_ID>(person) or
+// Edge<KNOWS>::Get<KNOWS_WEIGHT>(person_friends). Reading a field into the wrong type, reading an optional field with
+// Get(), or naming a field beyond the label's schema fails to compile. Field ids are plain
+// integers, so a field of another label with a valid id of this one cannot be told apart.
+template <uint16_t LABEL>
+struct Vertex {
+    template <size_t FIELD, typename It>
+    static typename VertexField<LABEL, FIELD>::type Get(const It& it) {
+        static_assert(!VertexField<LABEL, FIELD>::desc.optional, "optional field: use GetOr()");
+        return VertexField<LABEL, FIELD>::Get(it.GetField(FIELD));
+    }
+
+    template <size_t FIELD, typename It>
+    static typename VertexField<LABEL, FIELD>::type GetOr(const It& it,
+                                                          const typename VertexField<LABEL, FIELD>::type& value) {
+        auto fd = it.GetField(FIELD);
+        return fd.is_null() ? value : VertexField<LABEL, FIELD>::Get(fd);
+    }
+
+    // for optional fields known to be set here, such as the ones preprocess fills in; a null value throws
+    template <size_t FIELD, typename It>
+    static typename VertexField<LABEL, FIELD>::type GetRequired(const It& it) {
+        return VertexField<LABEL, FIELD>::Get(it.GetField(FIELD));
+    }
+
+    template <size_t FIELD, typename It>
+    static bool IsNull(const It& it) {
+        static_assert(VertexField<LABEL, FIELD>::desc.optional, "field is never null");
+        return it.GetField(FIELD).is_null();
+    }
+
+    // Adds delta to a numeric field, reading it and writing it back with SetField, which rewrites the whole record; a
+    // null value throws.
+    template <size_t FIELD, typename It>
+    static void Increment(It& it, typename VertexField<LABEL, FIELD>::type delta) {
+        using Field = VertexField<LABEL, FIELD>;
+        static_assert(std::is_arithmetic<typename Field::type>::value, "not a numeric field");
+        it.SetField(FIELD, Field::Make(Field::Get(it.GetField(FIELD)) + delta));
+    }
+};
+
+template <uint16_t LABEL>
+struct Edge {
+    template <size_t FIELD, typename It>
+    static typename EdgeField<LABEL, FIELD>::type Get(const It& it) {
+        static_assert(!EdgeField<LABEL, FIELD>::desc.optional, "optional field: use GetOr()");
+        return EdgeField<LABEL, FIELD>::Get(it.GetField(FIELD));
+    }
+
+    template <size_t FIELD, typename It>
+    static typename EdgeField<LABEL, FIELD>::type GetOr(const It& it,
+                                                        const typename EdgeField<LABEL, FIELD>::type& value) {
+        auto fd = it.GetField(FIELD);
+        return fd.is_null() ? value : EdgeField<LABEL, FIELD>::Get(fd);
+    }
+
+    // for optional fields known to be set here, such as the ones preprocess fills in; a null value throws
+    template <size_t FIELD, typename It>
+    static typename EdgeField<LABEL, FIELD>::type GetRequired(const It& it) {
+        return EdgeField<LABEL, FIELD>::Get(it.GetField(FIELD));
+    }
+
+    template <size_t FIELD, typename It>
+    static bool IsNull(const It& it) {
+        static_assert(EdgeField<LABEL, FIELD>::desc.optional, "field is never null");
+        return it.GetField(FIELD).is_null();
+    }
+
+    // adds delta to a numeric field, rewriting the record, as Vertex::Increment
+    template <size_t FIELD, typename It>
+    static void Increment(It& it, typename EdgeField<LABEL, FIELD>::type delta) {
+        using Field = EdgeField<LABEL, FIELD>;
+        static_assert(std::is_arithmetic<typename Field::type>::value, "not a numeric field");
+        it.SetField(FIELD, Field::Make(Field::Get(it.GetField(FIELD)) + delta));
+    }
+};
+
+// Reads the given fields of every vertex in vids through a single iterator, visiting the vertices in ascending vid
+// order so that consecutive lookups walk neighbouring B-tree pages; repeated vids are read once. fn(i, values) gets the
+// position of the vertex in vids and its fields in the order requested, all read by one GetFields call.
+//
+// This is how the queries made of independent pointer-chasing chains (IS2, IS7, IC3) interleave them: all chains
+// advance one hop per batch. Coroutine-interleaved execution, with each chain suspending after issuing a prefetch for
+// its next vertex, would gain nothing over this here: the API offers no prefetch or asynchronous lookup, a vertex read
+// stalls the thread until it returns, so there is no stall for a suspended chain to hide.
+template <typename Vids, typename Fn>
+inline void FetchVertices(lgraph_api::Transaction& txn, const Vids& vids, const std::vector<size_t>& fields, Fn&& fn) {
+    std::vector<size_t> order(vids.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    if (!std::is_sorted(vids.begin(), vids.end())) {
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return vids[a] < vids[b]; });
+    }
+    auto vit = txn.GetVertexIterator();
+    std::vector<lgraph_api::FieldData> values;
+    for (size_t k = 0; k < order.size(); k++) {
+        size_t i = order[k];
+        if (k == 0 || vids[i] != vids[order[k - 1]]) {
+            vit.Goto(vids[i]);
+            values = vit.GetFields(fields);
+        }
+        fn(i, values);
+    }
+}
+
+// Place, Organisation, Tag and TagClass vertices are never created or modified by updates, so their attributes are
+// loaded once per process and served from memory afterwards.
+struct DimensionEntry {
+    int64_t vid;
+    int64_t id;
+    uint16_t label;
+    // isPartOf for places, place for organisations, hasType for tags, isSubclassOf for tagclasses; -1 if absent
+    int64_t parent;
+    std::string name;
+    // only set for places and organisations
+    std::string type;
+    std::string url;
+};
+
+class Dimensions {
+    std::vector<DimensionEntry> entries_;
+    // (label, id, vid), sorted
+    std::vector<std::tuple<uint16_t, int64_t, int64_t>> vids_;
+
+    void Load(lgraph_api::Transaction& txn, uint16_t label, size_t id_fid, size_t parent_fid, size_t name_fid,
+              int64_t type_fid, size_t url_fid) {
+        auto min_id = lgraph_api::FieldData::Int64(std::numeric_limits<int64_t>::min());
+        auto max_id = lgraph_api::FieldData::Int64(std::numeric_limits<int64_t>::max());
+        auto vit = txn.GetVertexIterator();
+        for (auto iit = txn.GetVertexIndexIterator(label, id_fid, min_id, max_id); iit.IsValid(); iit.Next()) {
+            vit.Goto(iit.GetVid());
+            auto parent = vit[parent_fid];
+            entries_.emplace_back(DimensionEntry{vit.GetId(), vit[id_fid].integer(), label,
+                                                 parent.is_null() ? -1 : parent.integer(), vit[name_fid].string(),
+                                                 type_fid == -1 ? std::string() : vit[type_fid].string(),
+                                                 vit[url_fid].string()});
+        }
+    }
+
+   public:
+    explicit Dimensions(lgraph_api::Transaction& txn) {
+        Load(txn, PLACE, PLACE_ID, PLACE_ISPARTOF, PLACE_NAME, PLACE_TYPE, PLACE_URL);
+        Load(txn, ORGANISATION, ORGANISATION_ID, ORGANISATION_PLACE, ORGANISATION_NAME, ORGANISATION_TYPE,
+             ORGANISATION_URL);
+        Load(txn, TAG, TAG_ID, TAG_HASTYPE, TAG_NAME, -1, TAG_URL);
+        Load(txn, TAGCLASS, TAGCLASS_ID, TAGCLASS_ISSUBCLASSOF, TAGCLASS_NAME, -1, TAGCLASS_URL);
+        std::sort(entries_.begin(), entries_.end(),
+                  [](const DimensionEntry& a, const DimensionEntry& b) { return a.vid < b.vid; });
+        vids_.reserve(entries_.size());
+        for (auto& e : entries_) vids_.emplace_back(e.label, e.id, e.vid);
+        std::sort(vids_.begin(), vids_.end());
+    }
+
+    // the instance is built from the first transaction that asks for it
+    static const Dimensions& Get(lgraph_api::Transaction& txn) {
+        static const Dimensions dimensions(txn);
+        return dimensions;
+    }
+
+    // vid of the vertex with the given label and id, -1 if there is none
+    int64_t FindVid(uint16_t label, int64_t id) const {
+        auto it = std::lower_bound(vids_.begin(), vids_.end(),
+                                   std::make_tuple(label, id, std::numeric_limits<int64_t>::min()));
+        return (it != vids_.end() && std::get<0>(*it) == label && std::get<1>(*it) == id) ? std::get<2>(*it) : -1;
+    }
+
+    const DimensionEntry* Find(int64_t vid) const {
+        auto it = std::lower_bound(entries_.begin(), entries_.end(), vid,
+                                   [](const DimensionEntry& e, int64_t vid) { return e.vid < vid; });
+        return (it != entries_.end() && it->vid == vid) ? &*it : nullptr;
+    }
+
+    const DimensionEntry& operator[](int64_t vid) const {
+        auto entry = Find(vid);
+        if (entry == nullptr) throw std::runtime_error("vertex " + std::to_string(vid) + " is not a static dimension");
+        return *entry;
+    }
+
+    const std::string& Name(int64_t vid) const { return (*this)[vid].name; }
+
+    // all entries, in ascending vid order
+    const std::vector<DimensionEntry>& Entries() const { return entries_; }
+};
+
+#ifndef VID_CACHE_CAPACITY
+#define VID_CACHE_CAPACITY (1 << 20)
+#endif
+
+#ifndef VID_CACHE_SHM_PREFIX
+#define VID_CACHE_SHM_PREFIX "tugraph_snb_vids."
+#endif
+
+// id -> vid map of a label that updates append to (Person, Forum, Post, Comment). Every procedure is a library with
+// statics of its own, so the maps live in POSIX shared memory named after the server process: a vertex created by one
+// update procedure is resolved from memory by the others, and a restarted server, whose vids may differ (e.g. after a
+// restore), starts empty. Vertices are never deleted and vids never reused, so an entry stays valid once the vertex is
+// known to be committed. Each map is an open-addressing table of VID_CACHE_CAPACITY slots, written under a per-slot
+// sequence lock; an id whose probe window is full replaces the first slot of the window.
+class VidCache {
+    struct Slot {
+        std::atomic<uint64_t> seq;
+        std::atomic<int64_t> id;
+        // vid + 1, 0 while the slot is empty
+        std::atomic<int64_t> vid;
+    };
+    static constexpr size_t num_labels = 4;
+    static constexpr size_t probe_window = 8;
+    static constexpr size_t shm_bytes = sizeof(Slot) * VID_CACHE_CAPACITY * num_labels;
+
+    Slot* slots_;
+
+    // segments of servers that have exited
+    static void RemoveStale() {
+        DIR* dir = opendir("/dev/shm");
+        if (dir == nullptr) return;
+        const std::string prefix = VID_CACHE_SHM_PREFIX;
+        while (auto entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.compare(0, prefix.size(), prefix) != 0) continue;
+            pid_t pid = std::atoi(name.c_str() + prefix.size());
+            if (pid > 0 && kill(pid, 0) != 0 && errno == ESRCH) shm_unlink(("/" + name).c_str());
+        }
+        closedir(dir);
+    }
+
+    static Slot* Attach() {
+        std::string name = "/" VID_CACHE_SHM_PREFIX + std::to_string(getpid());
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd >= 0) {
+            RemoveStale();
+        } else {
+            fd = shm_open(name.c_str(), O_RDWR, 0600);
+            if (fd < 0) throw std::runtime_error("failed to open shared memory " + name);
+        }
+        if (ftruncate(fd, shm_bytes) != 0) {
+            close(fd);
+            throw std::runtime_error("failed to size shared memory " + name);
+        }
+        void* addr = mmap(nullptr, shm_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED) throw std::runtime_error("failed to map shared memory " + name);
+        return static_cast<Slot*>(addr);
+    }
+
+    size_t Home(int64_t id) const { return ((uint64_t(id) * 0x9E3779B97F4A7C15ull) >> 32) % VID_CACHE_CAPACITY; }
+
+    // reads a consistent slot; false if it is being written
+    static bool Read(const Slot& slot, int64_t& id, int64_t& vid) {
+        uint64_t seq = slot.seq.load(std::memory_order_acquire);
+        if (seq & 1) return false;
+        id = slot.id.load(std::memory_order_relaxed);
+        vid = slot.vid.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.seq.load(std::memory_order_relaxed) == seq;
+    }
+
+   public:
+    const uint16_t label;
+    const size_t id_fid;
+
+    VidCache(Slot* slots, uint16_t label, size_t id_fid) : slots_(slots), label(label), id_fid(id_fid) {}
+
+    static VidCache& Of(uint16_t label) {
+        static Slot* slots = Attach();
+        static VidCache persons(slots, PERSON, PERSON_ID),
+            forums(slots + VID_CACHE_CAPACITY, FORUM, FORUM_ID),
+            posts(slots + 2 * size_t(VID_CACHE_CAPACITY), POST, POST_ID),
+            comments(slots + 3 * size_t(VID_CACHE_CAPACITY), COMMENT, COMMENT_ID);
+        switch (label) {
+            case PERSON:
+                return persons;
+            case FORUM:
+                return forums;
+            case POST:
+                return posts;
+            case COMMENT:
+                return comments;
+            default:
+                throw std::runtime_error("no vid cache for label " + std::to_string(label));
+        }
+    }
+
+    bool Find(int64_t id, int64_t& vid) const {
+        size_t home = Home(id);
+        for (size_t i = 0; i < probe_window; i++) {
+            int64_t slot_id, slot_vid;
+            if (!Read(slots_[(home + i) % VID_CACHE_CAPACITY], slot_id, slot_vid)) continue;
+            // slots are never emptied, so an empty one ends the window
+            if (slot_vid == 0) return false;
+            if (slot_id == id) {
+                vid = slot_vid - 1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Insert(int64_t id, int64_t vid) {
+        size_t home = Home(id);
+        size_t target = home;
+        for (size_t i = 0; i < probe_window; i++) {
+            size_t pos = (home + i) % VID_CACHE_CAPACITY;
+            int64_t slot_id, slot_vid;
+            if (!Read(slots_[pos], slot_id, slot_vid)) continue;
+            if (slot_vid != 0 && slot_id == id) return;
+            if (slot_vid == 0) {
+                target = pos;
+                break;
+            }
+        }
+        auto& slot = slots_[target];
+        uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+        // a slot being written by someone else is left to them
+        if ((seq & 1) || !slot.seq.compare_exchange_strong(seq, seq + 1, std::memory_order_acquire)) return;
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.id.store(id, std::memory_order_relaxed);
+        slot.vid.store(vid + 1, std::memory_order_relaxed);
+        slot.seq.store(seq + 2, std::memory_order_release);
+    }
+};
+
+// Resolves the id of a vertex referenced by an update from memory where possible: static labels through Dimensions,
+// the others through VidCache. Only a miss probes the id index, within the update's own transaction.
+inline int64_t ResolveVid(lgraph_api::Transaction& txn, uint16_t label, int64_t id) {
+    int64_t vid = -1;
+    if (label == PLACE || label == ORGANISATION || label == TAG || label == TAGCLASS) {
+        vid = Dimensions::Get(txn).FindVid(label, id);
+    } else {
+        auto& cache = VidCache::Of(label);
+        if (cache.Find(id, vid)) return vid;
+        auto fd = lgraph_api::FieldData::Int64(id);
+        auto iit = txn.GetVertexIndexIterator(label, cache.id_fid, fd, fd);
+        if (iit.IsValid()) {
+            vid = iit.GetVid();
+            cache.Insert(id, vid);
+        }
+    }
+    if (vid == -1) {
+        throw std::runtime_error("no vertex of label " + std::to_string(label) + " with id " + std::to_string(id));
+    }
+    return vid;
+}
+
+// Makes concurrent optimistic updates that declare the same person conflict at commit, for updates that maintain values
+// derived from the person's edges without writing the person itself: the person's creationDate is rewritten with its
+// own value.
+inline void DeclareWriteIntent(lgraph_api::Transaction& txn, int64_t person_vid) {
+    auto person = txn.GetVertexIterator(person_vid);
+    person.SetField(PERSON_CREATIONDATE, person[PERSON_CREATIONDATE]);
+}
+
+#ifndef UPDATE_GROUP_COMMIT_WINDOW_US
+#define UPDATE_GROUP_COMMIT_WINDOW_US 0
+#endif
+
+// Group commit for a server running with "durable": false, where Commit() does not sync. A committed transaction takes
+// a ticket and waits until a flush that started after its commit has finished. The first waiter leads: it lets further
+// commits join for window_us, then syncs all of them with one GraphDB::Flush(). A group pays for one fsync instead of
+// one per transaction, and each transaction is acknowledged only after the flush; that this makes it as durable as a
+// durable commit is an assumption about Flush() that the durability test has yet to confirm for this build.
+class GroupCommit {
+    std::mutex mutex_;
+    std::condition_variable flushed_;
+    uint64_t committed_ = 0;
+    uint64_t durable_ = 0;
+    bool flushing_ = false;
+    uint64_t flushes_ = 0;
+
+   public:
+    static GroupCommit& Get() {
+        static GroupCommit group_commit;
+        return group_commit;
+    }
+
+    // to be called right after Commit() returns
+    uint64_t Committed() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return ++committed_;
+    }
+
+    void WaitDurable(lgraph_api::GraphDB& db, uint64_t ticket, int64_t window_us) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (durable_ < ticket) {
+            if (flushing_) {
+                flushed_.wait(lock);
+                continue;
+            }
+            flushing_ = true;
+            lock.unlock();
+            if (window_us > 0) std::this_thread::sleep_for(std::chrono::microseconds(window_us));
+            lock.lock();
+            uint64_t target = committed_;
+            lock.unlock();
+            try {
+                db.Flush();
+            } catch (...) {
+                lock.lock();
+                flushing_ = false;
+                flushed_.notify_all();
+                throw;
+            }
+            lock.lock();
+            durable_ = std::max(durable_, target);
+            flushing_ = false;
+            flushes_++;
+            flushed_.notify_all();
+        }
+    }
+
+    // (transactions committed, flushes issued) so far
+    std::pair<uint64_t, uint64_t> Counters() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return std::make_pair(committed_, flushes_);
+    }
+};
+
+// Short read result cache (SHORT_READ_CACHE). A short read records the vids its response depends on with DependOn(),
+// and an update names the existing persons and messages whose fields or edges it changes with NotifyWrite(). Both are
+// no-ops unless the plugin is built with SHORT_READ_CACHE, which every short read and update procedure then has to be.
+#ifdef SHORT_READ_CACHE
+
+#ifndef SHORT_READ_CACHE_SHM
+#define SHORT_READ_CACHE_SHM "/tugraph_snb_epochs"
+#endif
+
+#ifndef SHORT_READ_CACHE_SLOTS
+#define SHORT_READ_CACHE_SLOTS (1 << 18)
+#endif
+
+#ifndef SHORT_READ_CACHE_BYTES
+#define SHORT_READ_CACHE_BYTES (64 << 20)
+#endif
+
+#ifndef SHORT_READ_CACHE_REPORT_INTERVAL
+#define SHORT_READ_CACHE_REPORT_INTERVAL 1000000
+#endif
+
+// Write epochs of vids hashed into SHORT_READ_CACHE_SLOTS slots, kept in POSIX shared memory because every procedure
+// is a library with statics of its own. An update begins the slots of its write set before committing and ends them
+// after, stamping each with the value of a global clock. A response is cached only if none of its slots had an update
+// in progress or ended after the clock was read, which happens before its read transaction starts, and it stays valid
+// while its slots have not begun another update since.
+class EpochTable {
+    struct Slot {
+        std::atomic<uint64_t> begun;
+        std::atomic<uint64_t> ended;
+        std::atomic<uint64_t> last_end;
+    };
+
+    struct Shared {
+        std::atomic<uint64_t> clock;
+        Slot slots[SHORT_READ_CACHE_SLOTS];
+    };
+
+    Shared* shared_;
+
+    EpochTable() {
+        int fd = shm_open(SHORT_READ_CACHE_SHM, O_CREAT | O_RDWR, 0600);
+        if (fd < 0) throw std::runtime_error("failed to open shared memory " SHORT_READ_CACHE_SHM);
+        if (ftruncate(fd, sizeof(Shared)) != 0) {
+            close(fd);
+            throw std::runtime_error("failed to size shared memory " SHORT_READ_CACHE_SHM);
+        }
+        void* addr = mmap(nullptr, sizeof(Shared), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED) throw std::runtime_error("failed to map shared memory " SHORT_READ_CACHE_SHM);
+        shared_ = static_cast<Shared*>(addr);
+    }
+
+   public:
+    static EpochTable& Get() {
+        static EpochTable table;
+        return table;
+    }
+
+    static size_t SlotOf(int64_t vid) {
+        return ((uint64_t)vid * 0x9E3779B97F4A7C15ull >> 32) % SHORT_READ_CACHE_SLOTS;
+    }
+
+    uint64_t Clock() const { return shared_->clock.load(); }
+
+    void Begin(size_t slot) { shared_->slots[slot].begun++; }
+
+    void End(size_t slot) {
+        auto& s = shared_->slots[slot];
+        uint64_t now = ++shared_->clock;
+        uint64_t last = s.last_end.load();
+        while (last < now && !s.last_end.compare_exchange_weak(last, now)) {
+        }
+        s.ended++;
+    }
+
+    // the epoch of a slot with no update in progress and none ended after clock value since
+    bool Stable(size_t slot, uint64_t since, uint64_t& epoch) const {
+        auto& s = shared_->slots[slot];
+        uint64_t ended = s.ended.load();
+        if (s.begun.load() != ended || s.last_end.load() > since) return false;
+        epoch = ended;
+        return true;
+    }
+
+    bool Unchanged(size_t slot, uint64_t epoch) const {
+        auto& s = shared_->slots[slot];
+        return s.begun.load() == epoch && s.ended.load() == epoch;
+    }
+};
+
+// vids written by the update attempt in progress on this thread
+inline std::vector<int64_t>& CacheWriteSet() {
+    thread_local std::vector<int64_t> vids;
+    return vids;
+}
+
+inline void NotifyWrite(int64_t vid) { CacheWriteSet().push_back(vid); }
+
+// Begins the slots of the write set before a commit and ends them once it is over, committed or not.
+class WriteNotification {
+    std::vector<size_t> slots_;
+
+   public:
+    WriteNotification() {
+        for (auto vid : CacheWriteSet()) slots_.push_back(EpochTable::SlotOf(vid));
+        CacheWriteSet().clear();
+        std::sort(slots_.begin(), slots_.end());
+        slots_.erase(std::unique(slots_.begin(), slots_.end()), slots_.end());
+        for (auto slot : slots_) EpochTable::Get().Begin(slot);
+    }
+
+    ~WriteNotification() {
+        for (auto slot : slots_) EpochTable::Get().End(slot);
+    }
+};
+
+// vids the short read in progress on this thread depends on, if it is being cached
+inline std::vector<int64_t>*& CacheDependencies() {
+    thread_local std::vector<int64_t>* vids = nullptr;
+    return vids;
+}
+
+inline void DependOn(int64_t vid) {
+    auto vids = CacheDependencies();
+    if (vids != nullptr) vids->push_back(vid);
+}
+
+// Responses of one short read procedure by request, split into independently locked stripes, each of which is
+// dropped when it outgrows its share of SHORT_READ_CACHE_BYTES.
+class ResultCache {
+    static constexpr size_t num_stripes = 64;
+
+    struct Entry {
+        std::string response;
+        std::vector<std::pair<size_t, uint64_t>> epochs;  // (slot, epoch)
+    };
+
+    struct Stripe {
+        std::mutex mutex;
+        std::unordered_map<std::string, Entry> entries;
+        size_t bytes = 0;
+    };
+
+    std::array<Stripe, num_stripes> stripes_;
+    std::atomic<int64_t> bytes_{0};
+    std::atomic<uint64_t> hits_{0};
+
+    Stripe& StripeOf(const std::string& request) { return stripes_[std::hash<std::string>()(request) % num_stripes]; }
+
+    static size_t Bytes(const std::string& request, const Entry& entry) {
+        return request.size() + entry.response.size() + entry.epochs.size() * sizeof(entry.epochs[0]) + sizeof(Entry);
+    }
+
+   public:
+    std::atomic<uint64_t> lookups{0};
+
+    static ResultCache& Get() {
+        static ResultCache cache;
+        return cache;
+    }
+
+    bool Find(const std::string& request, std::string& response) {
+        auto& stripe = StripeOf(request);
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        auto it = stripe.entries.find(request);
+        if (it == stripe.entries.end()) return false;
+        for (auto& slot_epoch : it->second.epochs) {
+            if (!EpochTable::Get().Unchanged(slot_epoch.first, slot_epoch.second)) {
+                size_t bytes = Bytes(request, it->second);
+                stripe.bytes -= bytes;
+                bytes_ -= bytes;
+                stripe.entries.erase(it);
+                return false;
+            }
+        }
+        response = it->second.response;
+        hits_++;
+        return true;
+    }
+
+    // caches a response read after the clock showed since, unless an update on one of its vids may be missing in it
+    void Insert(const std::string& request, const std::string& response, const std::vector<int64_t>& vids,
+                uint64_t since) {
+        Entry entry;
+        entry.response = response;
+        for (auto vid : vids) {
+            size_t slot = EpochTable::SlotOf(vid);
+            uint64_t epoch;
+            if (!EpochTable::Get().Stable(slot, since, epoch)) return;
+            entry.epochs.emplace_back(slot, epoch);
+        }
+        size_t bytes = Bytes(request, entry);
+        auto& stripe = StripeOf(request);
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        if (stripe.bytes + bytes > SHORT_READ_CACHE_BYTES / num_stripes) {
+            bytes_ -= stripe.bytes;
+            stripe.entries.clear();
+            stripe.bytes = 0;
+        }
+        auto it = stripe.entries.find(request);
+        if (it != stripe.entries.end()) {
+            size_t old_bytes = Bytes(request, it->second);
+            stripe.bytes -= old_bytes;
+            bytes_ -= old_bytes;
+            it->second = std::move(entry);
+        } else {
+            stripe.entries.emplace(request, std::move(entry));
+        }
+        stripe.bytes += bytes;
+        bytes_ += bytes;
+    }
+
+    void Report(const char* name) const {
+        uint64_t n = lookups.load();
+        PluginLog(name) << "cache: lookups=" << n << " hit_rate=" << (n == 0 ? 0.0 : double(hits_.load()) / n)
+                        << " bytes=" << bytes_.load();
+    }
+};
+
+// Records the DependOn() calls of the short read on this thread while it lives.
+class DependencyRecorder {
+    std::vector<int64_t> vids_;
+
+   public:
+    DependencyRecorder() { CacheDependencies() = &vids_; }
+    ~DependencyRecorder() { CacheDependencies() = nullptr; }
+    const std::vector<int64_t>& vids() const { return vids_; }
+};
+
+#else
+
+inline void NotifyWrite(int64_t vid) {}
+
+inline void DependOn(int64_t vid) {}
+
+#endif
+
+// Process of a short read: runs read(db, txn, iss, oss) on the decoded request in a read transaction of its own.
+// With SHORT_READ_CACHE, responses are served from and added to the procedure's ResultCache. Short Read 1, 4, 5 and 6
+// only read fields that never change once written, so their responses depend on nothing.
+template <typename Fn>
+inline bool ProcessShortRead(lgraph_api::GraphDB& db, const char* name, const std::string& request,
+                             std::string& response, Fn&& read) {
+#ifdef SHORT_READ_CACHE
+    auto& cache = ResultCache::Get();
+    if (++cache.lookups % SHORT_READ_CACHE_REPORT_INTERVAL == 0) cache.Report(name);
+    if (cache.Find(request, response)) return true;
+    uint64_t since = EpochTable::Get().Clock();
+    DependencyRecorder recorder;
+#endif
+    std::string input = lgraph_api::base64::Decode(request);
+    std::stringstream iss(input);
+    auto txn = db.CreateReadTxn();
+    std::stringstream oss;
+    read(db, txn, iss, oss);
+    response = oss.str();
+#ifdef SHORT_READ_CACHE
+    cache.Insert(request, response, recorder.vids(), since);
+#endif
+    return true;
+}
+
+#ifndef UPDATE_MAX_ATTEMPTS
+#define UPDATE_MAX_ATTEMPTS 4
+#endif
+
+#ifndef UPDATE_BACKOFF_US
+#define UPDATE_BACKOFF_US 50
+#endif
+
+#ifndef UPDATE_METRICS_INTERVAL
+#define UPDATE_METRICS_INTERVAL 100000
+#endif
+
+// Outcome counters of the updates of a plugin, logged every UPDATE_METRICS_INTERVAL calls together with the retry
+// policy. Retry latency is the time from the first conflict of a call to its final outcome.
+struct UpdateMetrics {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> commits{0};
+    std::atomic<uint64_t> failures{0};
+    std::atomic<uint64_t> conflicts{0};
+    std::atomic<uint64_t> retried_calls{0};
+    std::atomic<uint64_t> retry_latency_us{0};
+    std::atomic<uint64_t> max_retry_latency_us{0};
+
+    static UpdateMetrics& Get() {
+        static UpdateMetrics metrics;
+        return metrics;
+    }
+
+    void RecordRetryLatency(uint64_t us) {
+        retried_calls++;
+        retry_latency_us += us;
+        uint64_t max = max_retry_latency_us.load(std::memory_order_relaxed);
+        while (us > max && !max_retry_latency_us.compare_exchange_weak(max, us)) {
+        }
+    }
+
+    void Report(const char* name) const {
+        uint64_t retried = retried_calls.load();
+        PluginLog log(name);
+        log << "metrics: calls=" << calls.load() << " commits=" << commits.load() << " failures=" << failures.load()
+            << " conflicts=" << conflicts.load() << " retried=" << retried
+            << " avg_retry_us=" << (retried == 0 ? 0 : retry_latency_us.load() / retried)
+            << " max_retry_us=" << max_retry_latency_us.load();
+#ifdef UPDATE_GROUP_COMMIT
+        auto counters = GroupCommit::Get().Counters();
+        log << " flushes=" << counters.second << " avg_group_size="
+            << (counters.second == 0 ? 0.0 : double(counters.first) / counters.second);
+#endif
+        log << " (attempts=" << UPDATE_MAX_ATTEMPTS << " backoff_us=" << UPDATE_BACKOFF_US;
+#ifdef UPDATE_GROUP_COMMIT
+        log << " group_commit_window_us=" << UPDATE_GROUP_COMMIT_WINDOW_US;
+#endif
+        log << ")";
+    }
+};
+
+// Runs body(txn) in a single write transaction and commits it. All but the last attempt are optimistic, validated at
+// commit; a conflict is retried after a randomized exponential backoff, and the last attempt runs pessimistically so
+// that it cannot conflict. Other errors are logged and end the update. With SHORT_READ_CACHE, the commit is bracketed
+// by a WriteNotification of the vids body passed to NotifyWrite(). Returns whether the update was committed (and, with
+// UPDATE_GROUP_COMMIT, synced by its group, a failed sync aborting the process); body may run several times, so it
+// must not change state outside the transaction.
+template <typename Fn>
+inline bool ExecuteUpdate(lgraph_api::GraphDB& db, const char* name, Fn&& body) {
+    thread_local std::minstd_rand rng(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    auto& metrics = UpdateMetrics::Get();
+    if (++metrics.calls % UPDATE_METRICS_INTERVAL == 0) metrics.Report(name);
+    std::chrono::steady_clock::time_point first_conflict;
+    bool committed = false;
+    for (int attempt = 1; attempt <= UPDATE_MAX_ATTEMPTS; attempt++) {
+        try {
+            auto txn = db.CreateWriteTxn(attempt < UPDATE_MAX_ATTEMPTS);
+#ifdef SHORT_READ_CACHE
+            CacheWriteSet().clear();
+#endif
+            body(txn);
+#ifdef SHORT_READ_CACHE
+            WriteNotification notification;
+#endif
+            txn.Commit();
+            committed = true;
+            break;
+        } catch (std::exception& e) {
+            if (std::string(e.what()).find("CONFLICTS") == std::string::npos) {
+                PluginLog(name) << "exception: " << e.what();
+                break;
+            }
+            metrics.conflicts++;
+            if (attempt == 1) first_conflict = std::chrono::steady_clock::now();
+            if (attempt + 1 < UPDATE_MAX_ATTEMPTS) {
+                std::uniform_int_distribution<int64_t> jitter(0, int64_t(UPDATE_BACKOFF_US) << (attempt - 1));
+                std::this_thread::sleep_for(std::chrono::microseconds(jitter(rng)));
+            }
+        }
+    }
+#ifdef UPDATE_GROUP_COMMIT
+    if (committed) {
+        auto& group_commit = GroupCommit::Get();
+        try {
+            group_commit.WaitDurable(db, group_commit.Committed(), UPDATE_GROUP_COMMIT_WINDOW_US);
+        } catch (std::exception& e) {
+            // the update is committed but not known to be durable; failing it would get it applied twice on retry
+            PluginLog(name) << "flush exception: " << e.what() << ", aborting";
+            std::abort();
+        }
+    }
+#endif
+    if (first_conflict != std::chrono::steady_clock::time_point()) {
+        metrics.RecordRetryLatency(std::chrono::duration_cast<std::chrono::microseconds>(
+                                       std::chrono::steady_clock::now() - first_conflict)
+                                       .count());
+    }
+    if (committed) {
+        metrics.commits++;
+    } else {
+        metrics.failures++;
+        PluginLog(name) << "failed";
+    }
+    return committed;
+}
+
+// Arrays of fixed-size records kept in a STRING field; a null field holds no records.
+template <typename T>
+inline std::vector<T> UnpackRecords(const lgraph_api::FieldData& fd) {
+    static_assert(std::is_trivially_copyable<T>::value, "records must be trivially copyable");
+    std::vector<T> records;
+    if (fd.is_null()) return records;
+    auto s = fd.string();
+    records.resize(s.size() / sizeof(T));
+    memcpy(records.data(), s.data(), records.size() * sizeof(T));
+    return records;
+}
+
+template <typename T>
+inline lgraph_api::FieldData PackRecords(const std::vector<T>& records) {
+    static_assert(std::is_trivially_copyable<T>::value, "records must be trivially copyable");
+    return lgraph_api::FieldData::String(
+        std::string(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(T)));
+}
+
+#ifndef RECENT_LIKERS_LIMIT
+#define RECENT_LIKERS_LIMIT 20
+#endif
+
+// Person.recentLikers keeps the latest like of each of the most recent likers of the person's messages, ordered by
+// creation date descending and then liker id ascending (the result order of Complex Read 7).
+struct RecentLike {
+    int64_t creation_date;
+    int64_t liker_id;
+    int64_t liker_vid;
+    int64_t message_id;
+    int64_t message_vid;
+
+    bool operator<(const RecentLike& rhs) const {
+        if (creation_date != rhs.creation_date) return creation_date > rhs.creation_date;
+        return liker_id < rhs.liker_id;
+    }
+};
+
+// Likes are never deleted, so a liker evicted from the view can only come back through a newer like, which is
+// offered here as well. Returns whether the view changed.
+inline bool OfferRecentLike(std::vector<RecentLike>& likes, const RecentLike& like) {
+    for (auto it = likes.begin(); it != likes.end(); it++) {
+        if (it->liker_vid != like.liker_vid) continue;
+        if (it->creation_date > like.creation_date ||
+            (it->creation_date == like.creation_date && it->message_id <= like.message_id))
+            return false;
+        likes.erase(it);
+        break;
+    }
+    auto pos = std::upper_bound(likes.begin(), likes.end(), like);
+    if (likes.size() >= RECENT_LIKERS_LIMIT && pos == likes.end()) return false;
+    likes.insert(pos, like);
+    if (likes.size() > RECENT_LIKERS_LIMIT) likes.pop_back();
+    return true;
+}
+
+#ifndef RECENT_REPLIES_LIMIT
+#define RECENT_REPLIES_LIMIT 32
+#endif
+
+// Person.recentReplies keeps the latest comments replying to the person's messages, ordered by creation date
+// descending and then comment id ascending (the result order of Complex Read 8).
+struct RecentReply {
+    int64_t creation_date;
+    int64_t comment_id;
+    int64_t comment_vid;
+    int64_t creator_vid;
+
+    bool operator<(const RecentReply& rhs) const {
+        if (creation_date != rhs.creation_date) return creation_date > rhs.creation_date;
+        return comment_id < rhs.comment_id;
+    }
+};
+
+// Comments are never deleted, so keeping the first RECENT_REPLIES_LIMIT replies is exact. Returns whether the view
+// changed.
+inline bool OfferRecentReply(std::vector<RecentReply>& replies, const RecentReply& reply) {
+    auto pos = std::upper_bound(replies.begin(), replies.end(), reply);
+    if (replies.size() >= RECENT_REPLIES_LIMIT && pos == replies.end()) return false;
+    replies.insert(pos, reply);
+    if (replies.size() > RECENT_REPLIES_LIMIT) replies.pop_back();
+    return true;
+}
+
+// First position in the sorted range [first, last) whose element is not less than value. The range is probed at
+// doubling distances from first, so repeated calls merging a short sorted sequence into a long one cost
+// O(m log(n / m)) instead of O(n).
+template <typename It, typename T>
+inline It GallopLowerBound(It first, It last, const T& value) {
+    if (first == last || !(*first < value)) return first;
+    size_t step = 1;
+    while (static_cast<size_t>(last - first) > step) {
+        auto next = first + step;
+        if (!(*next < value)) return std::lower_bound(first + 1, next + 1, value);
+        first = next;
+        step <<= 1;
+    }
+    return std::lower_bound(first + 1, last, value);
+}
+
+// Keeps the N smallest keys (under Compare) offered to it in a fixed-capacity max-heap, so offers never allocate
+// and keys that cannot make it are rejected by a single comparison with the current worst one.
+template <typename Key, size_t N, typename Compare = std::less<Key>>
+class TopK {
+    std::array<Key, N> heap_;
+    size_t size_ = 0;
+    Compare less_;
+
+   public:
+    size_t size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+    bool full() const { return size_ == N; }
+
+    // the key that will be evicted next; only valid when not empty
+    const Key& worst() const { return heap_[0]; }
+
+    bool Admits(const Key& key) const { return size_ < N || less_(key, heap_[0]); }
+
+    bool Offer(Key key) {
+        if (size_ < N) {
+            heap_[size_++] = std::move(key);
+            std::push_heap(heap_.begin(), heap_.begin() + size_, less_);
+            return true;
+        }
+        if (!less_(key, heap_[0])) return false;
+        std::pop_heap(heap_.begin(), heap_.end(), less_);
+        heap_[N - 1] = std::move(key);
+        std::push_heap(heap_.begin(), heap_.end(), less_);
+        return true;
+    }
+
+    // For tuple keys in lexicographic order: head is the first element, and make() builds the whole key. make() is
+    // only called when head does not already lose to the current worst key, so tie-break fields are fetched lazily.
+    template <typename Head, typename Make>
+    bool Offer(const Head& head, Make&& make) {
+        static_assert(std::is_same<Compare, std::less<Key>>::value, "lazy offers need lexicographic order");
+        if (size_ == N && std::get<0>(heap_[0]) < head) return false;
+        return Offer(make());
+    }
+
+    void Merge(const TopK& other) {
+        for (size_t i = 0; i < other.size_; i++) Offer(other.heap_[i]);
+    }
+
+    // keys from best to worst
+    std::vector<Key> Sorted() const {
+        std::vector<Key> keys(heap_.begin(), heap_.begin() + size_);
+        std::sort(keys.begin(), keys.end(), less_);
+        return keys;
+    }
+};
+
+#ifndef QUERY_ARENA_BLOCK_SIZE
+#define QUERY_ARENA_BLOCK_SIZE (1 << 20)
+#endif
+
+#ifndef QUERY_ARENA_RETAIN_LIMIT
+#define QUERY_ARENA_RETAIN_LIMIT (4 << 20)
+#endif
+
+// Monotonic bump allocator for the scratch containers of one query, one per thread. Deallocation is a no-op and
+// everything is released at once by Reset(), which keeps a single block sized for the footprint of the last query (at
+// least QUERY_ARENA_BLOCK_SIZE, at most QUERY_ARENA_RETAIN_LIMIT), so steady-state queries on a thread never reach
+// malloc. Every thread of every plugin keeps its block, so the limit bounds the memory held while idle; a block more
+// than four times what the last query needed is shrunk, so that one large query does not pin its footprint.
+class QueryArena {
+    struct Block {
+        Block* next;
+        size_t size;
+    };
+    static_assert(sizeof(Block) % alignof(std::max_align_t) == 0, "block payload must stay max-aligned");
+
+    Block* head_ = nullptr;
+    uintptr_t cur_ = 0;
+    uintptr_t end_ = 0;
+    size_t capacity_ = 0;
+    size_t used_ = 0;
+
+    void Grow(size_t bytes, size_t align) {
+        size_t size = std::max<size_t>(QUERY_ARENA_BLOCK_SIZE, capacity_);
+        size = std::max(size, sizeof(Block) + bytes + align);
+        auto block = static_cast<Block*>(std::malloc(size));
+        if (block == nullptr) throw std::bad_alloc();
+        block->next = head_;
+        block->size = size;
+        head_ = block;
+        capacity_ += size;
+        cur_ = reinterpret_cast<uintptr_t>(block + 1);
+        end_ = reinterpret_cast<uintptr_t>(block) + size;
+    }
+
+    void Release() {
+        while (head_ != nullptr) {
+            auto next = head_->next;
+            std::free(head_);
+            head_ = next;
+        }
+        cur_ = end_ = 0;
+        capacity_ = 0;
+    }
+
+   public:
+    QueryArena() = default;
+
+    QueryArena(const QueryArena&) = delete;
+
+    QueryArena& operator=(const QueryArena&) = delete;
+
+    ~QueryArena() { Release(); }
+
+    static QueryArena& Local() {
+        thread_local QueryArena arena;
+        return arena;
+    }
+
+    void* Allocate(size_t bytes, size_t align) {
+        uintptr_t p = (cur_ + align - 1) & ~static_cast<uintptr_t>(align - 1);
+        if (head_ == nullptr || p + bytes > end_) {
+            Grow(bytes, align);
+            p = (cur_ + align - 1) & ~static_cast<uintptr_t>(align - 1);
+        }
+        cur_ = p + bytes;
+        used_ += bytes;
+        return reinterpret_cast<void*>(p);
+    }
+
+    // bytes handed out since the last reset
+    size_t Used() const { return used_; }
+
+    void Reset() {
+        size_t size = std::max<size_t>(QUERY_ARENA_BLOCK_SIZE, sizeof(Block) + used_ + alignof(std::max_align_t));
+        size = std::min<size_t>(size, QUERY_ARENA_RETAIN_LIMIT);
+        if (head_ != nullptr &&
+            (head_->next != nullptr || capacity_ > QUERY_ARENA_RETAIN_LIMIT || capacity_ / 4 > size)) {
+            Release();
+            Grow(size - sizeof(Block) - alignof(std::max_align_t), alignof(std::max_align_t));
+        } else if (head_ != nullptr) {
+            cur_ = reinterpret_cast<uintptr_t>(head_ + 1);
+        }
+        used_ = 0;
+    }
+};
+
+// Allocates from the arena of the thread that constructed it. Containers using it must live within an ArenaScope
+// on that thread, so parallel workers keep their locals on the regular heap.
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    QueryArena* arena;
+
+    ArenaAllocator() : arena(&QueryArena::Local()) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(arena->Allocate(n * sizeof(T), alignof(T))); }
+
+    void deallocate(T*, size_t) {}
+};
+
+template <typename T, typename U>
+inline bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.arena == b.arena;
+}
+
+template <typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.arena != b.arena;
+}
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// The embedded tools are built without hopscotch-map on the include path.
+#ifdef __has_include
+#if __has_include("tsl/hopscotch_map.h")
+#include "tsl/hopscotch_map.h"
+#include "tsl/hopscotch_set.h"
+
+template <typename Key>
+using ArenaHashSet = tsl::hopscotch_set<Key, std::hash<Key>, std::equal_to<Key>, ArenaAllocator<Key>>;
+
+template <typename Key, typename T>
+using ArenaHashMap =
+    tsl::hopscotch_map<Key, T, std::hash<Key>, std::equal_to<Key>, ArenaAllocator<std::pair<Key, T>>>;
+#endif
+#endif
+
+// Rewinds the thread's arena when a query returns; declare it first in Process() so that every arena-backed container
+// is destroyed before it. Each plugin is a separate shared object, so the high-water mark kept here is per query type;
+// it is logged whenever it crosses a power of two.
+class ArenaScope {
+    const char* query_;
+    QueryArena& arena_;
+
+   public:
+    explicit ArenaScope(const char* query) : query_(query), arena_(QueryArena::Local()) {}
+
+    ArenaScope(const ArenaScope&) = delete;
+
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    ~ArenaScope() {
+        static std::atomic<size_t> high_water(0);
+        size_t used = arena_.Used();
+        size_t prev = high_water.load(std::memory_order_relaxed);
+        while (used > prev) {
+            if (high_water.compare_exchange_weak(prev, used, std::memory_order_relaxed)) {
+                if ((prev ^ used) > prev) {
+                    PluginLog(query_) << "arena high-water mark: " << used << " bytes";
+                }
+                break;
+            }
+        }
+        arena_.Reset();
+    }
+};
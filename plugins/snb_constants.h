@@ -3,12 +3,16 @@
 #define COMMENT_CREATOR 1
 #define COMMENT_ID 2
 #define COMMENT_LENGTH 3
-#define COMMENT_PLACE 4
-#define COMMENT_REPLYOFCOMMENT 5
-#define COMMENT_REPLYOFPOST 6
-#define COMMENT_BROWSERUSED 7
-#define COMMENT_CONTENT 8
-#define COMMENT_LOCATIONIP 9
+#define COMMENT_LIKECOUNT 4
+#define COMMENT_PLACE 5
+#define COMMENT_REPLYCOUNT 6
+#define COMMENT_REPLYOFCOMMENT 7
+#define COMMENT_REPLYOFPOST 8
+#define COMMENT_ROOTFORUM 9
+#define COMMENT_ROOTPOST 10
+#define COMMENT_BROWSERUSED 11
+#define COMMENT_CONTENT 12
+#define COMMENT_LOCATIONIP 13
 
 #define FORUM 1
 #define FORUM_CREATIONDATE 0
@@ -34,7 +38,9 @@
 #define PERSON_GENDER 7
 #define PERSON_LASTNAME 8
 #define PERSON_LOCATIONIP 9
-#define PERSON_SPEAKS 10
+#define PERSON_RECENTLIKERS 10
+#define PERSON_RECENTREPLIES 11
+#define PERSON_SPEAKS 12
 
 #define PLACE 4
 #define PLACE_ID 0
@@ -49,12 +55,14 @@
 #define POST_CREATOR 2
 #define POST_ID 3
 #define POST_LENGTH 4
-#define POST_PLACE 5
-#define POST_BROWSERUSED 6
-#define POST_CONTENT 7
-#define POST_IMAGEFILE 8
-#define POST_LANGUAGE 9
-#define POST_LOCATIONIP 10
+#define POST_LIKECOUNT 5
+#define POST_PLACE 6
+#define POST_REPLYCOUNT 7
+#define POST_BROWSERUSED 8
+#define POST_CONTENT 9
+#define POST_IMAGEFILE 10
+#define POST_LANGUAGE 11
+#define POST_LOCATIONIP 12
 
 #define TAG 6
 #define TAG_HASTYPE 0
@@ -123,3 +131,10 @@
 
 #define ISSUBCLASSOF 20
 
+#define WORKINCOUNTRY 21
+#define WORKINCOUNTRY_ORGANISATION 0
+#define WORKINCOUNTRY_WORKFROM 1
+
+#define INTERACTION 22
+#define INTERACTION_WEIGHT 0
+
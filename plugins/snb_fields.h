@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "lgraph/lgraph.h"
+
+// Compile-time field layouts. snb_schema.h, generated next to snb_constants.h, specializes VertexField and EdgeField
+// for every (label, field) pair of the schema; a field that does not exist in a label has no specialization.
+struct FieldDesc {
+    lgraph_api::FieldType type;
+    bool optional;
+    // holds a vid once preprocess has converted the foreign key or filled in the field
+    bool vid;
+};
+
+// Decoding and encoding of one field type; Get() checks the stored type once instead of dispatching over all integer
+// widths.
+template <lgraph_api::FieldType T>
+struct FieldValue;
+
+template <>
+struct FieldValue<lgraph_api::FieldType::BOOL> {
+    using type = bool;
+    static bool Get(const lgraph_api::FieldData& fd) { return fd.AsBool(); }
+    static lgraph_api::FieldData Make(bool value) { return lgraph_api::FieldData::Bool(value); }
+};
+
+template <>
+struct FieldValue<lgraph_api::FieldType::INT8> {
+    using type = int8_t;
+    static int8_t Get(const lgraph_api::FieldData& fd) { return fd.AsInt8(); }
+    static lgraph_api::FieldData Make(int8_t value) { return lgraph_api::FieldData::Int8(value); }
+};
+
+template <>
+struct FieldValue<lgraph_api::FieldType::INT16> {
+    using type = int16_t;
+    static int16_t Get(const lgraph_api::FieldData& fd) { return fd.AsInt16(); }
+    static lgraph_api::FieldData Make(int16_t value) { return lgraph_api::FieldData::Int16(value); }
+};
+
+template <>
+struct FieldValue<lgraph_api::FieldType::INT32> {
+    using type = int32_t;
+    static int32_t Get(const lgraph_api::FieldData& fd) { return fd.AsInt32(); }
+    static lgraph_api::FieldData Make(int32_t value) { return lgraph_api::FieldData::Int32(value); }
+};
+
+template <>
+struct FieldValue<lgraph_api::FieldType::INT64> {
+    using type = int64_t;
+    static int64_t Get(const lgraph_api::FieldData& fd) { return fd.AsInt64(); }
+    static lgraph_api::FieldData Make(int64_t value) { return lgraph_api::FieldData::Int64(value); }
+};
+
+template <>
+struct FieldValue<lgraph_api::FieldType::FLOAT> {
+    using type = float;
+    static float Get(const lgraph_api::FieldData& fd) { return fd.AsFloat(); }
+    static lgraph_api::FieldData Make(float value) { return lgraph_api::FieldData::Float(value); }
+};
+
+template <>
+struct FieldValue<lgraph_api::FieldType::DOUBLE> {
+    using type = double;
+    static double Get(const lgraph_api::FieldData& fd) { return fd.AsDouble(); }
+    static lgraph_api::FieldData Make(double value) { return lgraph_api::FieldData::Double(value); }
+};
+
+template <>
+struct FieldValue<lgraph_api::FieldType::STRING> {
+    using type = std::string;
+    static std::string Get(const lgraph_api::FieldData& fd) { return fd.AsString(); }
+    static lgraph_api::FieldData Make(const std::string& value) { return lgraph_api::FieldData::String(value); }
+};
+
+template <lgraph_api::FieldType T, bool OPTIONAL, bool VID>
+struct FieldTraits : FieldValue<T> {
+    static constexpr FieldDesc desc{T, OPTIONAL, VID};
+};
+
+template <lgraph_api::FieldType T, bool OPTIONAL, bool VID>
+constexpr FieldDesc FieldTraits<T, OPTIONAL, VID>::desc;
+
+template <uint16_t LABEL, size_t FIELD>
+struct VertexField;
+
+template <uint16_t LABEL, size_t FIELD>
+struct EdgeField;
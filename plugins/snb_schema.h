@@ -0,0 +1,317 @@
+// Generated by generate_snb_constants: VertexField and EdgeField specializations of the schema.
+#pragma once
+
+#include "snb_constants.h"
+#include "snb_fields.h"
+
+template <>
+struct VertexField<COMMENT, COMMENT_CREATIONDATE>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct VertexField<COMMENT, COMMENT_CREATOR>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, true> {};
+
+template <>
+struct VertexField<COMMENT, COMMENT_ID>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct VertexField<COMMENT, COMMENT_LENGTH>
+    : FieldTraits<lgraph_api::FieldType::INT32, false, false> {};
+
+template <>
+struct VertexField<COMMENT, COMMENT_LIKECOUNT>
+    : FieldTraits<lgraph_api::FieldType::INT32, true, false> {};
+
+template <>
+struct VertexField<COMMENT, COMMENT_PLACE>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, true> {};
+
+template <>
+struct VertexField<COMMENT, COMMENT_REPLYCOUNT>
+    : FieldTraits<lgraph_api::FieldType::INT32, true, false> {};
+
+template <>
+struct VertexField<COMMENT, COMMENT_REPLYOFCOMMENT>
+    : FieldTraits<lgraph_api::FieldType::INT64, true, true> {};
+
+template <>
+struct VertexField<COMMENT, COMMENT_REPLYOFPOST>
+    : FieldTraits<lgraph_api::FieldType::INT64, true, true> {};
+
+template <>
+struct VertexField<COMMENT, COMMENT_ROOTFORUM>
+    : FieldTraits<lgraph_api::FieldType::INT64, true, true> {};
+
+template <>
+struct VertexField<COMMENT, COMMENT_ROOTPOST>
+    : FieldTraits<lgraph_api::FieldType::INT64, true, true> {};
+
+template <>
+struct VertexField<COMMENT, COMMENT_BROWSERUSED>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct VertexField<COMMENT, COMMENT_CONTENT>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct VertexField<COMMENT, COMMENT_LOCATIONIP>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct VertexField<FORUM, FORUM_CREATIONDATE>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct VertexField<FORUM, FORUM_ID>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct VertexField<FORUM, FORUM_MODERATOR>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, true> {};
+
+template <>
+struct VertexField<FORUM, FORUM_TITLE>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct VertexField<ORGANISATION, ORGANISATION_ID>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct VertexField<ORGANISATION, ORGANISATION_PLACE>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, true> {};
+
+template <>
+struct VertexField<ORGANISATION, ORGANISATION_NAME>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct VertexField<ORGANISATION, ORGANISATION_TYPE>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct VertexField<ORGANISATION, ORGANISATION_URL>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct VertexField<PERSON, PERSON_BIRTHDAY>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct VertexField<PERSON, PERSON_CREATIONDATE>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct VertexField<PERSON, PERSON_ID>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct VertexField<PERSON, PERSON_PLACE>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, true> {};
+
+template <>
+struct VertexField<PERSON, PERSON_BROWSERUSED>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct VertexField<PERSON, PERSON_EMAIL>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct VertexField<PERSON, PERSON_FIRSTNAME>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct VertexField<PERSON, PERSON_GENDER>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct VertexField<PERSON, PERSON_LASTNAME>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct VertexField<PERSON, PERSON_LOCATIONIP>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct VertexField<PERSON, PERSON_RECENTLIKERS>
+    : FieldTraits<lgraph_api::FieldType::STRING, true, false> {};
+
+template <>
+struct VertexField<PERSON, PERSON_RECENTREPLIES>
+    : FieldTraits<lgraph_api::FieldType::STRING, true, false> {};
+
+template <>
+struct VertexField<PERSON, PERSON_SPEAKS>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct VertexField<PLACE, PLACE_ID>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct VertexField<PLACE, PLACE_ISPARTOF>
+    : FieldTraits<lgraph_api::FieldType::INT64, true, true> {};
+
+template <>
+struct VertexField<PLACE, PLACE_NAME>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct VertexField<PLACE, PLACE_TYPE>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct VertexField<PLACE, PLACE_URL>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct VertexField<POST, POST_CONTAINER>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, true> {};
+
+template <>
+struct VertexField<POST, POST_CREATIONDATE>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct VertexField<POST, POST_CREATOR>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, true> {};
+
+template <>
+struct VertexField<POST, POST_ID>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct VertexField<POST, POST_LENGTH>
+    : FieldTraits<lgraph_api::FieldType::INT32, false, false> {};
+
+template <>
+struct VertexField<POST, POST_LIKECOUNT>
+    : FieldTraits<lgraph_api::FieldType::INT32, true, false> {};
+
+template <>
+struct VertexField<POST, POST_PLACE>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, true> {};
+
+template <>
+struct VertexField<POST, POST_REPLYCOUNT>
+    : FieldTraits<lgraph_api::FieldType::INT32, true, false> {};
+
+template <>
+struct VertexField<POST, POST_BROWSERUSED>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct VertexField<POST, POST_CONTENT>
+    : FieldTraits<lgraph_api::FieldType::STRING, true, false> {};
+
+template <>
+struct VertexField<POST, POST_IMAGEFILE>
+    : FieldTraits<lgraph_api::FieldType::STRING, true, false> {};
+
+template <>
+struct VertexField<POST, POST_LANGUAGE>
+    : FieldTraits<lgraph_api::FieldType::STRING, true, false> {};
+
+template <>
+struct VertexField<POST, POST_LOCATIONIP>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct VertexField<TAG, TAG_HASTYPE>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, true> {};
+
+template <>
+struct VertexField<TAG, TAG_ID>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct VertexField<TAG, TAG_NAME>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct VertexField<TAG, TAG_URL>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct VertexField<TAGCLASS, TAGCLASS_ID>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct VertexField<TAGCLASS, TAGCLASS_ISSUBCLASSOF>
+    : FieldTraits<lgraph_api::FieldType::INT64, true, true> {};
+
+template <>
+struct VertexField<TAGCLASS, TAGCLASS_NAME>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct VertexField<TAGCLASS, TAGCLASS_URL>
+    : FieldTraits<lgraph_api::FieldType::STRING, false, false> {};
+
+template <>
+struct EdgeField<COMMENTHASCREATOR, COMMENTHASCREATOR_CREATIONDATE>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct EdgeField<COMMENTISLOCATEDIN, COMMENTISLOCATEDIN_CREATIONDATE>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct EdgeField<REPLYOF, REPLYOF_CREATIONDATE>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct EdgeField<HASMEMBER, HASMEMBER_FORUMID>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct EdgeField<HASMEMBER, HASMEMBER_JOINDATE>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct EdgeField<HASMEMBER, HASMEMBER_NUMPOSTS>
+    : FieldTraits<lgraph_api::FieldType::INT32, false, false> {};
+
+template <>
+struct EdgeField<KNOWS, KNOWS_CREATIONDATE>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct EdgeField<KNOWS, KNOWS_WEIGHT>
+    : FieldTraits<lgraph_api::FieldType::DOUBLE, false, false> {};
+
+template <>
+struct EdgeField<LIKES, LIKES_CREATIONDATE>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct EdgeField<STUDYAT, STUDYAT_CLASSYEAR>
+    : FieldTraits<lgraph_api::FieldType::INT32, false, false> {};
+
+template <>
+struct EdgeField<WORKAT, WORKAT_WORKFROM>
+    : FieldTraits<lgraph_api::FieldType::INT32, true, false> {};
+
+template <>
+struct EdgeField<POSTHASCREATOR, POSTHASCREATOR_CREATIONDATE>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct EdgeField<POSTISLOCATEDIN, POSTISLOCATEDIN_CREATIONDATE>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct EdgeField<WORKINCOUNTRY, WORKINCOUNTRY_ORGANISATION>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, true> {};
+
+template <>
+struct EdgeField<WORKINCOUNTRY, WORKINCOUNTRY_WORKFROM>
+    : FieldTraits<lgraph_api::FieldType::INT64, false, false> {};
+
+template <>
+struct EdgeField<INTERACTION, INTERACTION_WEIGHT>
+    : FieldTraits<lgraph_api::FieldType::DOUBLE, false, false> {};
@@ -0,0 +1,77 @@
+#include "lgraph/lgraph.h"
+
+#include "snb_constants.h"
+#include "snb_common.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+// Offers random (-count, id, vid) keys, shaped like the candidates of the complex reads, to TopK and to the std::set
+// top-k the queries used before it (insert, then erase the last key once over the limit), and prints the time per
+// offer of both. Counts are drawn from a narrow range, so most offers tie on the head and reach the tie-breaks. The
+// keys are offered in random order, where most are rejected early, and in descending order, where every offer is
+// admitted.
+//   ./topk_bench [num_offers] [rounds]
+
+using Key = std::tuple<int32_t, int64_t, int64_t>;
+
+template <size_t K>
+std::vector<Key> RunTopK(const std::vector<Key>& keys) {
+    TopK<Key, K> top;
+    for (auto& key : keys) top.Offer(std::get<0>(key), [&]() { return key; });
+    return top.Sorted();
+}
+
+template <size_t K>
+std::vector<Key> RunSet(const std::vector<Key>& keys) {
+    std::set<Key> top;
+    for (auto& key : keys) {
+        if (top.size() == K && !(key < *top.rbegin())) continue;
+        top.emplace(key);
+        if (top.size() > K) top.erase(std::prev(top.end()));
+    }
+    return std::vector<Key>(top.begin(), top.end());
+}
+
+template <size_t K>
+void Run(const char* order, const std::vector<Key>& keys, int rounds) {
+    double topk_seconds = 0, set_seconds = 0;
+    for (int r = 0; r < rounds; r++) {
+        auto begin = std::chrono::steady_clock::now();
+        auto a = RunTopK<K>(keys);
+        auto middle = std::chrono::steady_clock::now();
+        auto b = RunSet<K>(keys);
+        auto end = std::chrono::steady_clock::now();
+        if (a != b) throw std::runtime_error("TopK and std::set disagree");
+        topk_seconds += std::chrono::duration<double>(middle - begin).count();
+        set_seconds += std::chrono::duration<double>(end - middle).count();
+    }
+    double num_offers = double(rounds) * keys.size();
+    std::cout << order << "\t" << K << "\t" << topk_seconds / num_offers * 1e9 << "\t"
+              << set_seconds / num_offers * 1e9 << std::endl;
+}
+
+int main(int argc, char** argv) {
+    size_t num_offers = argc > 1 ? std::stoull(argv[1]) : 1000000;
+    int rounds = argc > 2 ? std::stoi(argv[2]) : 10;
+
+    std::mt19937_64 rng(0);
+    std::uniform_int_distribution<int32_t> count(-1000, 0);
+    std::vector<Key> keys;
+    for (size_t i = 0; i < num_offers; i++) keys.emplace_back(count(rng), int64_t(rng() >> 1), int64_t(i));
+
+    std::cout << "order\tk\ttopk_ns/offer\tset_ns/offer" << std::endl;
+    Run<10>("random", keys, rounds);
+    Run<20>("random", keys, rounds);
+    Run<100>("random", keys, rounds);
+    std::sort(keys.rbegin(), keys.rend());
+    Run<10>("descending", keys, rounds);
+    Run<20>("descending", keys, rounds);
+    Run<100>("descending", keys, rounds);
+    return 0;
+}
@@ -0,0 +1,63 @@
+#define UPDATE_WRITE_VOLUME
+
+#include "apply_updates.cpp"
+
+// Bytes written to storage per update, by update type. Applies the updates of the streams after the watermark one at a
+// time, each followed by its own flush, and charges the growth of write_bytes in /proc/self/io to the type of the
+// update. The updates stay in the database but the watermark is not advanced, so run it on a copy; running two builds
+// of the update procedures on copies of the same database shows what a change to them saves.
+//   ./update_write_volume db_path stream_dir [num_updates]
+
+uint64_t WrittenBytes() {
+    std::ifstream io("/proc/self/io");
+    std::string key;
+    uint64_t value;
+    while (io >> key >> value) {
+        if (key == "write_bytes:") return value;
+    }
+    throw std::runtime_error("no write_bytes in /proc/self/io");
+}
+
+int main(int argc, char** argv) {
+    std::string db_path(argv[1]);
+    std::string stream_dir(argv[2]);
+    size_t num_updates = argc > 3 ? std::stoull(argv[3]) : 100000;
+
+    auto paths = ListStreams(stream_dir);
+    if (paths.empty()) {
+        std::cout << "no updateStream_*.csv in " << stream_dir << std::endl;
+        return 1;
+    }
+    int64_t watermark = ReadWatermark(db_path + "/apply_updates.watermark");
+
+    lgraph_api::Galaxy galaxy(db_path, "admin", "73@TuGraph", false, false);
+    lgraph_api::GraphDB db = galaxy.OpenGraph("default");
+    db.Flush();
+
+    UpdateStreams streams(paths);
+    std::vector<uint64_t> num_applied(9, 0);
+    std::vector<uint64_t> bytes(9, 0);
+    size_t num_failed = 0;
+    Update update;
+    for (size_t i = 0; i < num_updates && streams.Next(update);) {
+        if (update.timestamp <= watermark) continue;
+        i++;
+        uint64_t before = WrittenBytes();
+        bool ok = Apply(db, update);
+        db.Flush();
+        if (!ok) {
+            num_failed++;
+            continue;
+        }
+        num_applied[update.type]++;
+        bytes[update.type] += WrittenBytes() - before;
+    }
+
+    std::cout << "type\tupdates\tbytes/update" << std::endl;
+    for (int type = 1; type <= 8; type++) {
+        std::cout << "IU" << type << "\t" << num_applied[type] << "\t"
+                  << (num_applied[type] == 0 ? 0 : double(bytes[type]) / num_applied[type]) << std::endl;
+    }
+    if (num_failed != 0) std::cout << num_failed << " updates failed" << std::endl;
+    return 0;
+}